@@ -0,0 +1,353 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Accuracy of the single precision build against the double build (make
+ * accuracy), the table in gmath.h. The program is built twice: the double
+ * build writes its results to the standard output, the single precision
+ * build (NMEA_SINGLE_PRECISION) computes its own from the same (float) inputs,
+ * reads those of the double build from the standard input and prints the
+ * maximum errors.
+ *
+ * The inputs are SAMPLES random positions with |lat| <= 80 degrees, and for
+ * every distance band a point at a log-uniform distance in the band in a
+ * random direction. Errors are in meters on the earth's surface (a sphere of
+ * NMEA_EARTHRADIUS_M), the first rows are the errors of storing an exact
+ * position in a float.
+ */
+
+#include <nmea/gmath.h>
+#include <nmea/tok.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLES 200000
+#define BANDS 3
+#define RADIUS ((double) NMEA_EARTHRADIUS_M)
+/* the error budget, in meters */
+#define BUDGET 1.0
+
+static const double bands[BANDS][2] = {
+  { 1.0, 1000.0 },
+  { 1000.0, 100000.0 },
+  { 100000.0, 10000000.0 }
+};
+
+/**
+ * The results of one sample, in both builds
+ */
+typedef struct _results {
+  double atof[2];         /**< nmea_atof of the NDEG of lat and lon */
+  double ndeg2degree[2];  /**< nmea_ndeg2degree of lat and lon */
+  double degree2ndeg[2];  /**< nmea_degree2ndeg of lat and lon */
+  double degree2radian[2]; /**< nmea_degree2radian of lat and lon */
+  double distance[BANDS];
+  double distance_ellipsoid[BANDS];
+  double move_horz[BANDS][2];       /**< lat and lon of the end position of nmea_move_horz */
+  double move_horz_ellipsoid[BANDS][2];
+  double pdop;
+} results;
+
+/**
+ * The inputs of one sample, the exact values and the float inputs of the
+ * functions
+ */
+typedef struct _inputs {
+  double degree[2];       /**< lat and lon in degrees */
+  double ndeg[2];         /**< lat and lon in NDEG */
+  char field[2][16];      /**< lat and lon as ddmm.mmmmm fields */
+  float degree_f[2];
+  float ndeg_f[2];
+  float from[2];          /**< The position in radians */
+  float to[BANDS][2];     /**< The point at a distance in every band */
+  float azimuth[BANDS];   /**< The direction of the points, in degrees */
+  float meters[BANDS];    /**< The distance of the points */
+  float hdop;
+  float vdop;
+} inputs;
+
+static uint64_t state = 0x9e3779b97f4a7c15ull;
+
+/**
+ * @return a uniform random number in [low, high) (xorshift64*)
+ */
+static double uniform(const double low, const double high) {
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return low + ((high - low) * (double) ((state * 0x2545f4914f6cdd1dull) >> 11) * 0x1.0p-53);
+}
+
+/**
+ * @return the NDEG of decimal degrees, in double
+ */
+static double ndeg(const double degree) {
+  double whole = trunc(degree);
+
+  return (whole * 100.0) + ((degree - whole) * 60.0);
+}
+
+/**
+ * Generate the next sample, the same in both builds
+ */
+static void generate(inputs *in) {
+  double lat;
+  double lon;
+  int i;
+
+  in->degree[0] = uniform(-80.0, 80.0);
+  in->degree[1] = uniform(-180.0, 180.0);
+  for (i = 0; i < 2; i++) {
+    double minutes = fabs(in->ndeg[i] = ndeg(in->degree[i]));
+
+    in->degree_f[i] = (float) in->degree[i];
+    in->ndeg_f[i] = (float) in->ndeg[i];
+    snprintf(in->field[i], sizeof(in->field[i]), "%.5f", minutes);
+  }
+
+  lat = (double) in->degree_f[0] * (M_PI / 180.0);
+  lon = (double) in->degree_f[1] * (M_PI / 180.0);
+  in->from[0] = (float) lat;
+  in->from[1] = (float) lon;
+  for (i = 0; i < BANDS; i++) {
+    double meters = exp(uniform(log(bands[i][0]), log(bands[i][1])));
+    double azimuth = uniform(0.0, 360.0);
+    double angle = meters / RADIUS;
+    double theta = azimuth * (M_PI / 180.0);
+    double lat2 = asin((sin(lat) * cos(angle)) + (cos(lat) * sin(angle) * cos(theta)));
+    double lon2 = lon + atan2(sin(theta) * sin(angle) * cos(lat), cos(angle) - (sin(lat) * sin(lat2)));
+
+    in->to[i][0] = (float) lat2;
+    in->to[i][1] = (float) lon2;
+    in->azimuth[i] = (float) azimuth;
+    in->meters[i] = (float) meters;
+  }
+
+  in->hdop = (float) uniform(0.5, 20.0);
+  in->vdop = (float) uniform(0.5, 20.0);
+}
+
+/**
+ * Run the functions of the build over a sample
+ */
+static void compute(const inputs *in, results *out) {
+  nmeaPOS from = { in->from[0], in->from[1] };
+  int i;
+
+  memset(out, 0, sizeof(*out));
+  for (i = 0; i < 2; i++) {
+    out->atof[i] = (double) nmea_atof(in->field[i], (int) strlen(in->field[i]));
+    out->ndeg2degree[i] = (double) nmea_ndeg2degree(in->ndeg_f[i]);
+    out->degree2ndeg[i] = (double) nmea_degree2ndeg(in->degree_f[i]);
+    out->degree2radian[i] = (double) nmea_degree2radian(in->degree_f[i]);
+  }
+
+  for (i = 0; i < BANDS; i++) {
+    nmeaPOS to = { in->to[i][0], in->to[i][1] };
+    nmeaPOS end;
+
+    out->distance[i] = (double) nmea_distance(&from, &to);
+    out->distance_ellipsoid[i] = (double) nmea_distance_ellipsoid(&from, &to, NULL, NULL);
+    /* nmea_move_horz takes km, nmea_move_horz_ellipsoid meters and radians */
+    nmea_move_horz(&from, &end, in->azimuth[i], in->meters[i] / 1000.0f);
+    out->move_horz[i][0] = (double) end.lat;
+    out->move_horz[i][1] = (double) end.lon;
+    nmea_move_horz_ellipsoid(&from, &end, nmea_degree2radian(in->azimuth[i]), in->meters[i], NULL);
+    out->move_horz_ellipsoid[i][0] = (double) end.lat;
+    out->move_horz_ellipsoid[i][1] = (double) end.lon;
+  }
+
+  out->pdop = (double) nmea_calc_pdop(in->hdop, in->vdop);
+}
+
+#if NMEA_SINGLE_PRECISION
+/**
+ * The maximum errors of a row of the table
+ */
+typedef struct _row {
+  const char *name;
+  int columns;            /**< 1, or BANDS for the distance functions */
+  double error[BANDS];
+} row;
+
+/**
+ * Raise a maximum, an error that is not a number (the single precision build
+ * failed where the double build did not) counts as infinite
+ */
+static void update(double *max, double error) {
+  if (isnan(error)) {
+    error = INFINITY;
+  }
+  if (error > *max) {
+    *max = error;
+  }
+}
+
+/**
+ * @return the error of a coordinate in meters, from its error in degrees
+ */
+static double coordinate_error(const int coordinate, const double lat, const double degrees) {
+  double meters = fabs(degrees) * (M_PI / 180.0) * RADIUS;
+
+  return coordinate ? (meters * cos(lat * (M_PI / 180.0))) : meters;
+}
+
+/**
+ * @return the distance between two positions in radians that are close, in
+ * meters
+ */
+static double position_error(const double a[2], const double b[2]) {
+  double dlon = remainder(a[1] - b[1], 2.0 * M_PI);
+
+  return RADIUS * hypot(a[0] - b[0], dlon * cos(a[0]));
+}
+
+/**
+ * @return the distance in ulps of the float nearest to value
+ */
+static double ulps(const float value, const double exact) {
+  float nearest = (float) exact;
+
+  return fabs((double) value - (double) nearest) / (double) (nextafterf(fabsf(nearest), INFINITY) - fabsf(nearest));
+}
+
+/**
+ * Print a cell of the table, the errors over the budget are marked with *
+ */
+static void print_cell(const double error, const bool last) {
+  char value[16];
+
+  snprintf(value, sizeof(value), (error < 100.0) ? "%.2f" : "%.0f", error);
+  printf("%8s m", value);
+  if (error > BUDGET) {
+    printf(" *");
+  } else if (!last) {
+    printf("  ");
+  }
+}
+
+int main(void) {
+  enum { NDEG, DEGREES, RADIANS, ATOF, NDEG2DEGREE, DEGREE2NDEG, DEGREE2RADIAN, DISTANCE, DISTANCE_ELLIPSOID,
+    MOVE_HORZ, MOVE_HORZ_ELLIPSOID, ROWS };
+  row rows[ROWS] = {
+    [NDEG] = { "float storage of NDEG", 1, { 0 } },
+    [DEGREES] = { "float storage of degrees", 1, { 0 } },
+    [RADIANS] = { "float storage of radians", 1, { 0 } },
+    [ATOF] = { "nmea_atof (ddmm.mmmmm)", 1, { 0 } },
+    [NDEG2DEGREE] = { "nmea_ndeg2degree", 1, { 0 } },
+    [DEGREE2NDEG] = { "nmea_degree2ndeg", 1, { 0 } },
+    [DEGREE2RADIAN] = { "nmea_degree2radian", 1, { 0 } },
+    [DISTANCE] = { "nmea_distance (haversine)", BANDS, { 0 } },
+    [DISTANCE_ELLIPSOID] = { "nmea_distance_ellipsoid", BANDS, { 0 } },
+    [MOVE_HORZ] = { "nmea_move_horz", BANDS, { 0 } },
+    [MOVE_HORZ_ELLIPSOID] = { "nmea_move_horz_ellipsoid", BANDS, { 0 } },
+  };
+  double small_ndeg = 0.0;
+  double atof_ulps = 0.0;
+  double pdop = 0.0;
+  int n;
+  int i;
+  int r;
+
+  for (n = 0; n < SAMPLES; n++) {
+    inputs in;
+    results single;
+    results reference;
+
+    generate(&in);
+    compute(&in, &single);
+    if (fread(&reference, sizeof(reference), 1, stdin) != 1) {
+      fprintf(stderr, "accuracy: expected the results of the double build on the standard input\n");
+      return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < 2; i++) {
+      double lat = in.degree[0];
+      /* an error of the minutes of NDEG, in degrees */
+      double ndeg_storage = ((double) in.ndeg_f[i] - in.ndeg[i]) / 60.0;
+
+      update(&rows[NDEG].error[0], coordinate_error(i, lat, ndeg_storage));
+      if (fabs(in.ndeg[i]) < 16384.0) {
+        update(&small_ndeg, coordinate_error(i, lat, ndeg_storage));
+      }
+      update(&rows[DEGREES].error[0], coordinate_error(i, lat, (double) in.degree_f[i] - in.degree[i]));
+      update(&rows[RADIANS].error[0], coordinate_error(i, lat,
+          ((double) (float) (in.degree[i] * (M_PI / 180.0)) - (in.degree[i] * (M_PI / 180.0))) * (180.0 / M_PI)));
+
+      /* the fields carry the magnitude of the NDEG */
+      update(&rows[ATOF].error[0], coordinate_error(i, lat, (single.atof[i] - reference.atof[i]) / 60.0));
+      update(&atof_ulps, ulps((float) single.atof[i], reference.atof[i]));
+      update(&rows[NDEG2DEGREE].error[0], coordinate_error(i, lat, single.ndeg2degree[i] - reference.ndeg2degree[i]));
+      update(&rows[DEGREE2NDEG].error[0], coordinate_error(i, lat,
+          (single.degree2ndeg[i] - reference.degree2ndeg[i]) / 60.0));
+      update(&rows[DEGREE2RADIAN].error[0], coordinate_error(i, lat,
+          (single.degree2radian[i] - reference.degree2radian[i]) * (180.0 / M_PI)));
+    }
+
+    for (i = 0; i < BANDS; i++) {
+      update(&rows[DISTANCE].error[i], fabs(single.distance[i] - reference.distance[i]));
+      update(&rows[DISTANCE_ELLIPSOID].error[i], fabs(single.distance_ellipsoid[i] - reference.distance_ellipsoid[i]));
+      update(&rows[MOVE_HORZ].error[i], position_error(single.move_horz[i], reference.move_horz[i]));
+      update(&rows[MOVE_HORZ_ELLIPSOID].error[i],
+          position_error(single.move_horz_ellipsoid[i], reference.move_horz_ellipsoid[i]));
+    }
+
+    update(&pdop, fabs(single.pdop - reference.pdop) / reference.pdop);
+  }
+
+  printf(" %-30s 1 m - 1 km   1 - 100 km   100 - 10000 km\n", "function");
+  for (r = 0; r < ROWS; r++) {
+    printf(" %-30s", rows[r].name);
+    for (i = 0; i < rows[r].columns; i++) {
+      print_cell(rows[r].error[i], (i == (rows[r].columns - 1)) && (r != NDEG) && (r != ATOF));
+      if (i < (rows[r].columns - 1)) {
+        printf("  ");
+      }
+    }
+    if (r == NDEG) {
+      printf("   (up to %.1f m for NDEG < 16384)", small_ndeg);
+    } else if (r == ATOF) {
+      printf("   (the storage error, %.0f ulp at most)", atof_ulps);
+    }
+    printf("\n");
+  }
+  printf(" %-30s relative error %.1e\n", "nmea_calc_pdop", pdop);
+  return EXIT_SUCCESS;
+}
+#else
+int main(void) {
+  int n;
+
+  for (n = 0; n < SAMPLES; n++) {
+    inputs in;
+    results reference;
+
+    generate(&in);
+    compute(&in, &reference);
+    if (fwrite(&reference, sizeof(reference), 1, stdout) != 1) {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,554 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Throughput benchmark of the parser over a recorded corpus (make bench): the
+ * parser as a whole (nmea_parse), the splitting of the fields, the decoder of
+ * each sentence type, nmea_scanf as the decoders used it before the fields
+ * were split once, nmea_atoi and nmea_atof over all the fields, the
+ * conversions into nmeaINFO and the distance functions of gmath.
+ *
+ * The sentences that the benchmarks other than nmea_parse work on are those
+ * that the parser decodes from the corpus, each benchmark takes those of its
+ * type. Every benchmark is timed REPEATS times over at least RUN_NS, the
+ * median run gives the rates, the fastest and the slowest run show the spread.
+ */
+
+#include <nmea/conversions.h>
+#include <nmea/gmath.h>
+#include <nmea/parse.h>
+#include <nmea/parser.h>
+#include <nmea/tok.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPEATS 9
+#define RUN_NS 20000000ull
+#define MAX_SAMPLES 8192
+
+/**
+ * A decoded sentence of the corpus
+ */
+typedef struct _sample {
+  enum nmeaPACKTYPE type;
+  char s[SENTENCE_SIZE];
+  int len;
+  nmeaFIELDS fields;
+
+  union {
+#if NMEA_SENTENCE_GGA
+    nmeaGPGGA gpgga;
+#endif
+#if NMEA_SENTENCE_GSA
+    nmeaGPGSA gpgsa;
+#endif
+#if NMEA_SENTENCE_GSV
+    nmeaGPGSV gpgsv;
+#endif
+#if NMEA_SENTENCE_RMC
+    nmeaGPRMC gprmc;
+#endif
+#if NMEA_SENTENCE_VTG
+    nmeaGPVTG gpvtg;
+#endif
+  } pack;
+} sample;
+
+/**
+ * A benchmark: one pass over its input, and the size of the input
+ */
+typedef struct _benchmark {
+  const char *name;
+  void (*pass)(const enum nmeaPACKTYPE type);
+  enum nmeaPACKTYPE type;
+  size_t bytes;
+  unsigned int sentences;
+} benchmark;
+
+static char *corpus;
+static size_t corpus_size;
+static int corpus_sentences;
+
+static sample samples[MAX_SAMPLES];
+static int sample_count;
+
+static nmeaPARSER parser;
+static nmeaINFO info;
+#if NMEA_SENTENCE_GSV
+static nmeaGSVCYCLE cycle;
+#endif
+static nmeaPOS positions[MAX_SAMPLES];
+static int position_count;
+
+/* keeps the results of the passes alive */
+static volatile nmeaFLOAT sink;
+
+static uint64_t now_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t) now.tv_sec * 1000000000u) + (uint64_t) now.tv_nsec;
+}
+
+static void capture(const enum nmeaPACKTYPE type, const void *pack, const char *s, const int len, void *arg) {
+  sample *sample = &samples[sample_count];
+
+  (void) arg;
+
+  if ((sample_count >= MAX_SAMPLES) || (len > (int) sizeof(sample->s))) {
+    return;
+  }
+
+  sample->type = type;
+  memcpy(sample->s, s, (size_t) len);
+  sample->len = len;
+  nmea_parse_fields(sample->s, sample->len, &sample->fields);
+  switch (type) {
+#if NMEA_SENTENCE_GGA
+    case GPGGA:
+      sample->pack.gpgga = *(const nmeaGPGGA *) pack;
+      break;
+#endif
+#if NMEA_SENTENCE_GSA
+    case GPGSA:
+      sample->pack.gpgsa = *(const nmeaGPGSA *) pack;
+      break;
+#endif
+#if NMEA_SENTENCE_GSV
+    case GPGSV:
+      sample->pack.gpgsv = *(const nmeaGPGSV *) pack;
+      break;
+#endif
+#if NMEA_SENTENCE_RMC
+    case GPRMC:
+      sample->pack.gprmc = *(const nmeaGPRMC *) pack;
+      break;
+#endif
+#if NMEA_SENTENCE_VTG
+    case GPVTG:
+      sample->pack.gpvtg = *(const nmeaGPVTG *) pack;
+      break;
+#endif
+    default:
+      return;
+  }
+  sample_count++;
+}
+
+static void pass_parse(const enum nmeaPACKTYPE type) {
+  (void) type;
+  sink = nmea_parse(&parser, corpus, (int) corpus_size, &info);
+}
+
+static void pass_fields(const enum nmeaPACKTYPE type) {
+  nmeaFIELDS fields;
+  int i;
+
+  (void) type;
+
+  for (i = 0; i < sample_count; i++) {
+    sink = nmea_parse_fields(samples[i].s, samples[i].len, &fields);
+  }
+}
+
+static void pass_decode(const enum nmeaPACKTYPE type) {
+  int i;
+
+  for (i = 0; i < sample_count; i++) {
+    sample *sample = &samples[i];
+
+    if (sample->type != type) {
+      continue;
+    }
+
+    switch (type) {
+#if NMEA_SENTENCE_GGA
+      case GPGGA: {
+        nmeaGPGGA pack;
+        sink = nmea_parse_GPGGA_fields(sample->s, sample->len, &sample->fields, VALIDATE_FULL, &pack);
+        break;
+      }
+#endif
+#if NMEA_SENTENCE_GSA
+      case GPGSA: {
+        nmeaGPGSA pack;
+        sink = nmea_parse_GPGSA_fields(sample->s, sample->len, &sample->fields, VALIDATE_FULL, &pack);
+        break;
+      }
+#endif
+#if NMEA_SENTENCE_GSV
+      case GPGSV: {
+        nmeaGPGSV pack;
+        sink = nmea_parse_GPGSV_fields(sample->s, sample->len, &sample->fields, VALIDATE_FULL, &pack);
+        break;
+      }
+#endif
+#if NMEA_SENTENCE_RMC
+      case GPRMC: {
+        nmeaGPRMC pack;
+        sink = nmea_parse_GPRMC_fields(sample->s, sample->len, &sample->fields, VALIDATE_FULL, &pack);
+        break;
+      }
+#endif
+#if NMEA_SENTENCE_VTG
+      case GPVTG: {
+        nmeaGPVTG pack;
+        sink = nmea_parse_GPVTG_fields(sample->s, sample->len, &sample->fields, VALIDATE_FULL, &pack);
+        break;
+      }
+#endif
+      default:
+        break;
+    }
+  }
+}
+
+/**
+ * nmea_scanf with the formats of the decoders before the fields were split
+ * once (the talker is skipped)
+ */
+static void pass_scanf(const enum nmeaPACKTYPE type) {
+  char text[SENTENCE_SIZE];
+  char header[8];
+  char c[4];
+  double f[4];
+  int d[19];
+  int i;
+
+  (void) type;
+
+  for (i = 0; i < sample_count; i++) {
+    const char *s = samples[i].s;
+    int len = samples[i].len;
+
+    switch (samples[i].type) {
+      case GPGGA:
+        sink = nmea_scanf(s, len, "$%5s,%s,%f,%c,%f,%c,%d,%d,%f,%f,%c,%f,%c,%f,%d*", header, text, &f[0], &c[0],
+            &f[1], &c[1], &d[0], &d[1], &f[2], &f[3], &c[2], &f[0], &c[3], &f[1], &d[2]);
+        break;
+
+      case GPGSA:
+        sink = nmea_scanf(s, len, "$%5s,%c,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%f,%f,%f*", header, &c[0], &d[0],
+            &d[1], &d[2], &d[3], &d[4], &d[5], &d[6], &d[7], &d[8], &d[9], &d[10], &d[11], &d[12], &f[0], &f[1],
+            &f[2]);
+        break;
+
+      case GPGSV:
+        sink = nmea_scanf(s, len, "$%5s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d*", header,
+            &d[0], &d[1], &d[2], &d[3], &d[4], &d[5], &d[6], &d[7], &d[8], &d[9], &d[10], &d[11], &d[12], &d[13],
+            &d[14], &d[15], &d[16], &d[17], &d[18]);
+        break;
+
+      case GPRMC:
+        sink = nmea_scanf(s, len, "$%5s,%s,%c,%f,%c,%f,%c,%f,%f,%d,%f,%c,%c*", header, text, &c[0], &f[0], &c[1],
+            &f[1], &c[2], &f[2], &f[3], &d[0], &f[0], &c[3], &c[0]);
+        break;
+
+      case GPVTG:
+        sink = nmea_scanf(s, len, "$%5s,%f,%c,%f,%c,%f,%c,%f,%c*", header, &f[0], &c[0], &f[1], &c[1], &f[2], &c[2],
+            &f[3], &c[3]);
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+static void pass_atoi(const enum nmeaPACKTYPE type) {
+  int i;
+  int field;
+
+  (void) type;
+
+  for (i = 0; i < sample_count; i++) {
+    for (field = 1; field < samples[i].fields.count; field++) {
+      const nmeaFIELD *f = &samples[i].fields.field[field];
+
+      sink = nmea_atoi(&samples[i].s[f->offset], f->length, 10);
+    }
+  }
+}
+
+static void pass_atof(const enum nmeaPACKTYPE type) {
+  int i;
+  int field;
+
+  (void) type;
+
+  for (i = 0; i < sample_count; i++) {
+    for (field = 1; field < samples[i].fields.count; field++) {
+      const nmeaFIELD *f = &samples[i].fields.field[field];
+
+      sink = nmea_atof(&samples[i].s[f->offset], f->length);
+    }
+  }
+}
+
+static void pass_convert(const enum nmeaPACKTYPE type) {
+  int i;
+
+  for (i = 0; i < sample_count; i++) {
+    sample *sample = &samples[i];
+
+    if (sample->type != type) {
+      continue;
+    }
+
+    switch (type) {
+#if NMEA_SENTENCE_GGA
+      case GPGGA:
+        nmea_GPGGA2info(&sample->pack.gpgga, &info);
+        break;
+#endif
+#if NMEA_SENTENCE_GSA
+      case GPGSA:
+        nmea_GPGSA2info(&sample->pack.gpgsa, &info);
+        break;
+#endif
+#if NMEA_SENTENCE_GSV
+      case GPGSV:
+        nmea_GPGSV2cycle(&sample->pack.gpgsv, &cycle, &info);
+        break;
+#endif
+#if NMEA_SENTENCE_RMC
+      case GPRMC:
+        nmea_GPRMC2info(&sample->pack.gprmc, &info);
+        break;
+#endif
+#if NMEA_SENTENCE_VTG
+      case GPVTG:
+        nmea_GPVTG2info(&sample->pack.gpvtg, &info);
+        break;
+#endif
+      default:
+        break;
+    }
+  }
+  sink = info.smask;
+}
+
+static void pass_distance(const enum nmeaPACKTYPE type) {
+  int i;
+
+  (void) type;
+
+  for (i = 1; i < position_count; i++) {
+    sink = nmea_distance(&positions[i - 1], &positions[i]);
+  }
+}
+
+static void pass_distance_ellipsoid(const enum nmeaPACKTYPE type) {
+  int i;
+
+  (void) type;
+
+  for (i = 1; i < position_count; i++) {
+    sink = nmea_distance_ellipsoid(&positions[i - 1], &positions[i], NULL, NULL);
+  }
+}
+
+static int compare(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *) a;
+  uint64_t y = *(const uint64_t *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * Time a benchmark and print its rates
+ */
+static void run(const benchmark *bench) {
+  uint64_t runs[REPEATS];
+  uint64_t start;
+  unsigned int passes = 1;
+  unsigned int pass;
+  double median;
+  int repeat;
+
+  if (!bench->sentences) {
+    return;
+  }
+
+  /* warm up, and find the number of passes of a run */
+  for (;;) {
+    start = now_ns();
+    for (pass = 0; pass < passes; pass++) {
+      bench->pass(bench->type);
+    }
+    if ((now_ns() - start) >= RUN_NS) {
+      break;
+    }
+    passes *= 2;
+  }
+
+  for (repeat = 0; repeat < REPEATS; repeat++) {
+    start = now_ns();
+    for (pass = 0; pass < passes; pass++) {
+      bench->pass(bench->type);
+    }
+    runs[repeat] = now_ns() - start;
+  }
+  qsort(runs, REPEATS, sizeof(runs[0]), compare);
+
+  median = (double) runs[REPEATS / 2] / ((double) passes * bench->sentences);
+  printf("%-26s %8zu %6u ", bench->name, bench->bytes, bench->sentences);
+  if (bench->bytes) {
+    printf("%10.1f", (bench->bytes * 1e3) / (median * bench->sentences));
+  } else {
+    printf("%10s", "-");
+  }
+  printf(" %12.0f %9.1f  %7.1f-%.1f\n", 1e9 / median, median,
+      (double) runs[0] / ((double) passes * bench->sentences),
+      (double) runs[REPEATS - 1] / ((double) passes * bench->sentences));
+}
+
+static bool load(const char *path) {
+  FILE *file = fopen(path, "rb");
+  long size;
+
+  if (!file) {
+    perror(path);
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  corpus = malloc((size_t) size);
+  corpus_size = fread(corpus, 1, (size_t) size, file);
+  fclose(file);
+  return corpus_size == (size_t) size;
+}
+
+/**
+ * Sum the bytes and count the sentences of a type (GPNON for all)
+ */
+static void input(benchmark *bench) {
+  int i;
+
+  bench->bytes = 0;
+  bench->sentences = 0;
+  for (i = 0; i < sample_count; i++) {
+    if ((bench->type == GPNON) || (samples[i].type == bench->type)) {
+      bench->bytes += (size_t) samples[i].len;
+      bench->sentences++;
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  static const struct {
+    enum nmeaPACKTYPE type;
+    const char *decoder;
+    const char *converter;
+  } types[] = {
+#if NMEA_SENTENCE_GGA
+    { GPGGA, "nmea_parse_GPGGA_fields", "nmea_GPGGA2info" },
+#endif
+#if NMEA_SENTENCE_GSA
+    { GPGSA, "nmea_parse_GPGSA_fields", "nmea_GPGSA2info" },
+#endif
+#if NMEA_SENTENCE_GSV
+    { GPGSV, "nmea_parse_GPGSV_fields", "nmea_GPGSV2cycle" },
+#endif
+#if NMEA_SENTENCE_RMC
+    { GPRMC, "nmea_parse_GPRMC_fields", "nmea_GPRMC2info" },
+#endif
+#if NMEA_SENTENCE_VTG
+    { GPVTG, "nmea_parse_GPVTG_fields", "nmea_GPVTG2info" },
+#endif
+  };
+  benchmark bench;
+  size_t i;
+
+  if ((argc != 2) || !load(argv[1])) {
+    fprintf(stderr, "usage: %s corpus\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  /* decode the corpus once, to collect the sentences and the positions */
+  nmea_parser_init(&parser);
+  for (i = 0; i < (sizeof(types) / sizeof(types[0])); i++) {
+    nmea_parser_set_callback(&parser, types[i].type, capture, NULL);
+  }
+  nmea_zero_INFO(&info);
+  corpus_sentences = nmea_parse(&parser, corpus, (int) corpus_size, &info);
+  nmea_parser_init(&parser);
+  for (i = 0; i < (size_t) sample_count; i++) {
+#if NMEA_SENTENCE_GGA
+    if (samples[i].type == GPGGA) {
+      nmea_GPGGA2info(&samples[i].pack.gpgga, &info);
+      nmea_info2pos(&info, &positions[position_count++]);
+    }
+#endif
+  }
+
+  printf("corpus %s: %zu bytes, %d sentences decoded\n\n", argv[1], corpus_size, corpus_sentences);
+  printf("%-26s %8s %6s %10s %12s %9s  %s\n", "", "bytes", "count", "MB/s", "sentences/s", "ns/sent", "min-max");
+
+  bench = (benchmark) { "nmea_parse", pass_parse, GPNON, corpus_size, (unsigned int) corpus_sentences };
+  run(&bench);
+
+  bench = (benchmark) { "nmea_parse_fields", pass_fields, GPNON, 0, 0 };
+  input(&bench);
+  run(&bench);
+
+  for (i = 0; i < (sizeof(types) / sizeof(types[0])); i++) {
+    bench = (benchmark) { types[i].decoder, pass_decode, types[i].type, 0, 0 };
+    input(&bench);
+    run(&bench);
+  }
+
+  bench = (benchmark) { "nmea_scanf", pass_scanf, GPNON, 0, 0 };
+  input(&bench);
+  run(&bench);
+
+  bench = (benchmark) { "nmea_atoi (all fields)", pass_atoi, GPNON, 0, 0 };
+  input(&bench);
+  run(&bench);
+
+  bench = (benchmark) { "nmea_atof (all fields)", pass_atof, GPNON, 0, 0 };
+  input(&bench);
+  run(&bench);
+
+  for (i = 0; i < (sizeof(types) / sizeof(types[0])); i++) {
+    bench = (benchmark) { types[i].converter, pass_convert, types[i].type, 0, 0 };
+    input(&bench);
+    run(&bench);
+  }
+
+  /* per pair of successive GGA positions */
+  if (position_count > 1) {
+    bench = (benchmark) { "nmea_distance", pass_distance, GPNON, 0, (unsigned int) position_count - 1 };
+    run(&bench);
+
+    bench = (benchmark) { "nmea_distance_ellipsoid", pass_distance_ellipsoid, GPNON, 0,
+        (unsigned int) position_count - 1 };
+    run(&bench);
+  }
+
+  free(corpus);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,466 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Worst-case execution time harness of the parser (make wcet): feeds
+ * nmea_parse and the decoder of each sentence type with adversarial input and
+ * records the maximum cycles per byte and per sentence, then fails when a
+ * maximum exceeds its bound.
+ *
+ * The input: sentences of the maximum length (82 characters) with the longest
+ * valid values, sentences with all their fields empty, sentences with as many
+ * digits in their numbers as fit in the parser buffer (still valid, so that
+ * they are decoded), runs of '$' that reset the sentence, runs of invalid and
+ * escape characters inside and outside the sentences. The inputs other than
+ * the empty sentences must decode their sentence, the harness fails otherwise.
+ *
+ * Every input is fed whole and one character at a time, REPEATS times into a
+ * parser that merges into nmeaINFO; each cost is the fastest of the repeats,
+ * so that preemption and cache misses of the host do not count. The maxima:
+ * - per byte: of a character that does not complete a sentence, and of the
+ *   whole input divided by its length
+ * - per sentence: of the character that completes a sentence (the decoding
+ *   and the merge), and of the decoder on its own
+ *
+ * The cycles are those of the time stamp counter on x86, ticks of
+ * nmea_platform_ticks (nanoseconds) elsewhere.
+ */
+
+#include <nmea/parse.h>
+#include <nmea/parser.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES() __rdtsc()
+#define CYCLES_UNIT "TSC cycles"
+#else
+#define CYCLES() nmea_platform_ticks()
+#define CYCLES_UNIT "ns"
+#endif
+
+#define REPEATS 25
+#define MAX_INPUTS 64
+#define INPUT_SIZE 2048
+
+/** the longest sentence of the standard: 82 characters with '$', '*hh' and CR LF */
+#define MAX_SENTENCE 82
+
+/**
+ * An adversarial input
+ */
+typedef struct _input {
+  char name[40];
+  enum nmeaPACKTYPE type;         /**< the type of the sentence to decode, GPNON for none */
+  int sentences;                  /**< the number of sentences that must be decoded, -1 for any */
+  char s[INPUT_SIZE];
+  int len;
+} input;
+
+/**
+ * The costs of an input, the fastest of the repeats
+ */
+typedef struct _cost {
+  uint64_t whole;                 /**< the input fed at once */
+  uint64_t byte;                  /**< the costliest character that does not complete a sentence */
+  uint64_t sentence;              /**< the costliest character that completes a sentence */
+  uint64_t decoder;               /**< the decoder on its own */
+} cost;
+
+static input inputs[MAX_INPUTS];
+static int input_count;
+
+static nmeaPARSER parser;
+static nmeaINFO info;
+
+/**
+ * Add an input
+ */
+static input * add(const char *name, const enum nmeaPACKTYPE type, const int sentences) {
+  input *in = &inputs[input_count++];
+
+  snprintf(in->name, sizeof(in->name), "%s", name);
+  in->type = type;
+  in->sentences = sentences;
+  in->len = 0;
+  return in;
+}
+
+static void append(input *in, const char *s, const int len) {
+  if ((in->len + len) <= INPUT_SIZE) {
+    memcpy(&in->s[in->len], s, (size_t) len);
+    in->len += len;
+  }
+}
+
+static void repeat(input *in, const char c, const int count) {
+  int i;
+
+  for (i = 0; i < count; i++) {
+    append(in, &c, 1);
+  }
+}
+
+/**
+ * Append a sentence: '$', the body, the checksum and CR LF
+ */
+static void append_sentence(input *in, const char *body) {
+  char s[INPUT_SIZE];
+  unsigned char checksum = 0;
+  const char *c;
+
+  for (c = body; *c; c++) {
+    checksum ^= (unsigned char) *c;
+  }
+  append(in, s, snprintf(s, sizeof(s), "$%s*%02X\r\n", body, checksum));
+}
+
+/**
+ * Join the fields with commas into a body
+ */
+static void join(char *body, char fields[][INPUT_SIZE], const int count) {
+  int i;
+
+  body[0] = '\0';
+  for (i = 0; i < count; i++) {
+    if (i) {
+      strcat(body, ",");
+    }
+    strcat(body, fields[i]);
+  }
+}
+
+/**
+ * Lengthen the numbers of the fields (marked by numeric) in turn until the
+ * body is limit characters long, keeping them in their valid ranges: with
+ * leading zeros, or with fraction digits ('9's after the last digit, which
+ * make the most significant digits) for the numbers with a decimal point
+ */
+static void grow(char *body, char fields[][INPUT_SIZE], const int count, const char *numeric, const int limit,
+    const bool fraction) {
+  int i = 0;
+
+  join(body, fields, count);
+  while ((int) strlen(body) < limit) {
+    char *field;
+
+    while (numeric[i] != 'n') {
+      i = (i + 1) % count;
+    }
+
+    field = fields[i];
+    if (fraction && strchr(field, '.')) {
+      strcat(field, "9");
+    } else {
+      size_t sign = (field[0] == '-') ? 1 : 0;
+
+      memmove(&field[sign + 1], &field[sign], strlen(field) - sign + 1);
+      field[sign] = '0';
+    }
+
+    i = (i + 1) % count;
+    join(body, fields, count);
+  }
+}
+
+/**
+ * Add the adversarial sentences of a type: the longest valid values padded to
+ * the maximum length, all the fields empty, as many digits as fit in the
+ * parser buffer. numeric marks the number fields with 'n'.
+ */
+static void add_type(const enum nmeaPACKTYPE type, const char *name, const char **values, const char *numeric) {
+  char fields[NMEA_MAXFIELDS][INPUT_SIZE];
+  char body[INPUT_SIZE];
+  char label[40];
+  int count = (int) strlen(numeric);
+  int i;
+
+  /* the body leaves room for '$', '*hh' and CR LF */
+  for (i = 0; i < count; i++) {
+    strcpy(fields[i], values[i]);
+  }
+  grow(body, fields, count, numeric, MAX_SENTENCE - 6, false);
+  snprintf(label, sizeof(label), "%s max length", name);
+  append_sentence(add(label, type, 1), body);
+
+  for (i = 0; i < count; i++) {
+    strcpy(fields[i], i ? "" : values[0]);
+  }
+  join(body, fields, count);
+  snprintf(label, sizeof(label), "%s all empty", name);
+  append_sentence(add(label, type, -1), body);
+
+  /* the sentence fills the parser buffer */
+  for (i = 0; i < count; i++) {
+    strcpy(fields[i], values[i]);
+  }
+  grow(body, fields, count, numeric, SENTENCE_SIZE - 8, true);
+  snprintf(label, sizeof(label), "%s max digits", name);
+  append_sentence(add(label, type, 1), body);
+}
+
+static void add_inputs(void) {
+  static const char *gga[] = { "GPGGA", "235959.990", "8959.999", "S", "17959.999", "W", "8", "12", "99.9",
+      "-999.9", "M", "-99.9", "M", "99.9", "1023" };
+  static const char *gsa[] = { "GPGSA", "M", "3", "32", "32", "32", "32", "32", "32", "32", "32", "32", "32", "32",
+      "32", "99.9", "99.9", "99.9", "6" };
+  static const char *gsv[] = { "GPGSV", "9", "9", "36", "32", "90", "359", "99", "32", "90", "359", "99", "32", "90",
+      "359", "99", "32", "90", "359", "99", "1" };
+  static const char *rmc[] = { "GPRMC", "235959.990", "A", "8959.9999", "S", "17959.9999", "W", "999.9", "359.9",
+      "311299", "179.9", "W", "D", "V" };
+  static const char *vtg[] = { "GPVTG", "359.9", "T", "359.9", "M", "999.9", "N", "1851.9", "K", "D" };
+  static const char *reference = "GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,";
+  input *in;
+  int i;
+
+  add_type(GPGGA, "GGA", gga, "--n-n-nnnn-n-nn");
+  add_type(GPGSA, "GSA", gsa, "--nnnnnnnnnnnnnnnnn");
+  add_type(GPGSV, "GSV", gsv, "-nnnnnnnnnnnnnnnnnnnn");
+  add_type(GPRMC, "RMC", rmc, "---n-n-nn-n---");
+  add_type(GPVTG, "VTG", vtg, "-n-n-n-n--");
+
+  /* '$' resets the sentence */
+  in = add("'$' run", GPGGA, 1);
+  repeat(in, '$', 1000);
+  append_sentence(in, reference);
+
+  in = add("'$' in every field", GPGGA, 1);
+  for (i = 0; i < 20; i++) {
+    append(in, "$GPGGA,1,$GPGGA,$GP", 19);
+  }
+  append_sentence(in, reference);
+
+  in = add("'$' after the checksum", GPGGA, 1);
+  for (i = 0; i < 100; i++) {
+    append(in, "$GPGGA,,*", 9);
+    append(in, "$", 1);
+  }
+  append_sentence(in, reference);
+
+  /* invalid and escape characters */
+  in = add("invalid run", GPGGA, 1);
+  for (i = 0; i < 1000; i++) {
+    char c = (char) ((i % 2) ? 0xff : 0x01);
+
+    append(in, &c, 1);
+  }
+  append_sentence(in, reference);
+
+  in = add("escape run", GPGGA, 1);
+  for (i = 0; i < 250; i++) {
+    append(in, "^\\!~", 4);
+  }
+  append_sentence(in, reference);
+
+  in = add("invalid in sentences", GPGGA, 1);
+  for (i = 0; i < 20; i++) {
+    append(in, "$GPGGA,123519.000,4807.038,N^2C,01131.000", 41);
+  }
+  append_sentence(in, reference);
+
+  in = add("no line feed", GPGGA, 1);
+  for (i = 0; i < 20; i++) {
+    append(in, "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\r", 72);
+  }
+  append_sentence(in, reference);
+}
+
+/**
+ * Feed an input to a parser in the state after nmea_parser_init
+ */
+static void reset(void) {
+  nmea_parser_init(&parser);
+  nmea_zero_INFO(&info);
+}
+
+/**
+ * Decode the last sentence of an input on its own
+ */
+static uint64_t decode(const input *in) {
+  nmeaFIELDS fields;
+  const char *s = in->s;
+  const char *star;
+  uint64_t start;
+  uint64_t cycles;
+  int len;
+
+  /* the last sentence, from its '$' to the checksum */
+  while ((star = memchr(s + 1, '$', (size_t) (in->len - (s + 1 - in->s))))) {
+    s = star;
+  }
+  star = memchr(s, '*', (size_t) (in->len - (s - in->s)));
+  len = (int) (star ? (star - s + 3) : (in->len - (s - in->s)));
+  nmea_parse_fields(s, len, &fields);
+
+  start = CYCLES();
+  switch (in->type) {
+#if NMEA_SENTENCE_GGA
+    case GPGGA: {
+      nmeaGPGGA pack;
+      nmea_parse_GPGGA_fields(s, len, &fields, VALIDATE_FULL, &pack);
+      break;
+    }
+#endif
+#if NMEA_SENTENCE_GSA
+    case GPGSA: {
+      nmeaGPGSA pack;
+      nmea_parse_GPGSA_fields(s, len, &fields, VALIDATE_FULL, &pack);
+      break;
+    }
+#endif
+#if NMEA_SENTENCE_GSV
+    case GPGSV: {
+      nmeaGPGSV pack;
+      nmea_parse_GPGSV_fields(s, len, &fields, VALIDATE_FULL, &pack);
+      break;
+    }
+#endif
+#if NMEA_SENTENCE_RMC
+    case GPRMC: {
+      nmeaGPRMC pack;
+      nmea_parse_GPRMC_fields(s, len, &fields, VALIDATE_FULL, &pack);
+      break;
+    }
+#endif
+#if NMEA_SENTENCE_VTG
+    case GPVTG: {
+      nmeaGPVTG pack;
+      nmea_parse_GPVTG_fields(s, len, &fields, VALIDATE_FULL, &pack);
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+  cycles = CYCLES() - start;
+
+  return cycles;
+}
+
+static uint64_t min(const uint64_t a, const uint64_t b) {
+  return (a < b) ? a : b;
+}
+
+/**
+ * Measure an input, the fastest of the repeats
+ *
+ * @return the number of sentences that the parser decoded from the input
+ */
+static int measure(const input *in, cost *c) {
+  static uint64_t bytes[INPUT_SIZE];
+  static bool completes[INPUT_SIZE];
+  int sentences = 0;
+  int r;
+  int i;
+
+  memset(c, 0xff, sizeof(*c));
+  for (i = 0; i < in->len; i++) {
+    bytes[i] = UINT64_MAX;
+    completes[i] = false;
+  }
+
+  for (r = 0; r < REPEATS; r++) {
+    uint64_t start;
+
+    reset();
+    start = CYCLES();
+    sentences = nmea_parse(&parser, in->s, in->len, &info);
+    c->whole = min(c->whole, CYCLES() - start);
+
+    reset();
+    for (i = 0; i < in->len; i++) {
+      int completed;
+
+      start = CYCLES();
+      completed = nmea_parse(&parser, &in->s[i], 1, &info);
+      bytes[i] = min(bytes[i], CYCLES() - start);
+      completes[i] = completed || (in->s[i] == '\n');
+    }
+
+    c->decoder = min(c->decoder, decode(in));
+  }
+
+  c->byte = 0;
+  c->sentence = 0;
+  for (i = 0; i < in->len; i++) {
+    if (completes[i]) {
+      c->sentence = (bytes[i] > c->sentence) ? bytes[i] : c->sentence;
+    } else {
+      c->byte = (bytes[i] > c->byte) ? bytes[i] : c->byte;
+    }
+  }
+  if (in->type == GPNON) {
+    c->decoder = 0;
+  }
+
+  return sentences;
+}
+
+int main(int argc, char *argv[]) {
+  uint64_t byte_bound;
+  uint64_t sentence_bound;
+  uint64_t max_byte = 0;
+  uint64_t max_sentence = 0;
+  bool decoded = true;
+  bool ok;
+  int i;
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <bound per byte> <bound per sentence> (%s)\n", argv[0], CYCLES_UNIT);
+    return EXIT_FAILURE;
+  }
+  byte_bound = strtoull(argv[1], NULL, 10);
+  sentence_bound = strtoull(argv[2], NULL, 10);
+
+  add_inputs();
+
+  printf("%-24s %6s %5s %9s %9s %9s %9s %9s\n", "input", "bytes", "sent", "whole", "per byte", "max byte",
+      "max sent", "decoder");
+  for (i = 0; i < input_count; i++) {
+    const input *in = &inputs[i];
+    cost c;
+    int sentences = measure(in, &c);
+    uint64_t per_byte = (c.whole + (uint64_t) in->len - 1) / (uint64_t) in->len;
+
+    printf("%-24s %6d %5d %9llu %9llu %9llu %9llu %9llu\n", in->name, in->len, sentences,
+        (unsigned long long) c.whole, (unsigned long long) per_byte, (unsigned long long) c.byte,
+        (unsigned long long) c.sentence, (unsigned long long) c.decoder);
+
+    if ((in->sentences >= 0) && (sentences != in->sentences)) {
+      printf("%-24s decoded %d sentences instead of %d: FAILED\n", in->name, sentences, in->sentences);
+      decoded = false;
+    }
+
+    max_byte = (per_byte > max_byte) ? per_byte : max_byte;
+    max_byte = (c.byte > max_byte) ? c.byte : max_byte;
+    max_sentence = (c.sentence > max_sentence) ? c.sentence : max_sentence;
+    max_sentence = (c.decoder > max_sentence) ? c.decoder : max_sentence;
+  }
+
+  ok = decoded && (max_byte <= byte_bound) && (max_sentence <= sentence_bound);
+  printf("\nmaximum %s: %llu per byte (bound %llu), %llu per sentence (bound %llu): %s\n", CYCLES_UNIT,
+      (unsigned long long) max_byte, (unsigned long long) byte_bound, (unsigned long long) max_sentence,
+      (unsigned long long) sentence_bound, ok ? "ok" : "EXCEEDED");
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -28,15 +28,29 @@ extern "C" {
 
 int nmea_gsv_npack(int sat_count);
 
+#if NMEA_SENTENCE_GGA
 void nmea_GPGGA2info(const nmeaGPGGA *pack, nmeaINFO *info);
+#endif
 
+#if NMEA_SENTENCE_GSA
 void nmea_GPGSA2info(const nmeaGPGSA *pack, nmeaINFO *info);
+#endif
 
+#if NMEA_SENTENCE_GSV
 void nmea_GPGSV2info(const nmeaGPGSV *pack, nmeaINFO *info);
 
+int nmea_GPGSV2cycle(const nmeaGPGSV *pack, nmeaGSVCYCLE *cycle, nmeaINFO *info);
+
+void nmea_GSVcycle2info(nmeaGSVCYCLE *cycle, nmeaINFO *info);
+#endif
+
+#if NMEA_SENTENCE_RMC
 void nmea_GPRMC2info(const nmeaGPRMC *pack, nmeaINFO *info);
+#endif
 
+#if NMEA_SENTENCE_VTG
 void nmea_GPVTG2info(const nmeaGPVTG *pack, nmeaINFO *info);
+#endif
 
 #ifdef  __cplusplus
 }
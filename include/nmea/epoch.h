@@ -0,0 +1,88 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __NMEA_EPOCH_H__
+#define __NMEA_EPOCH_H__
+
+#include <nmea/info.h>
+#include <nmea/nmeaconf.h>
+#include <nmea/parser.h>
+#include <nmea/sentence.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * The rules that close an epoch, they can be combined
+ */
+enum nmeaEPOCH_CLOSE {
+	EPOCH_CLOSE_TIME = (1u << 0),		/**< A sentence with another UTC time (GGA, RMC) closes the epoch before it is merged. */
+	EPOCH_CLOSE_COMPLETE = (1u << 1),	/**< The epoch closes when all expected sentence types were received and no GSV cycle is in progress. */
+	EPOCH_CLOSE_TIMEOUT = (1u << 2)		/**< The epoch closes when no sentence was received for the timeout (see nmea_epoch_poll). */
+};
+
+/**
+ * An epoch callback, called once per epoch with the consolidated information
+ * of the epoch. The changed mask of the information holds the fields that
+ * changed during the epoch.
+ *
+ * @param info a pointer to the information, valid during the call only
+ * @param arg the argument that was given to nmea_epoch_init
+ */
+typedef void (*nmeaEPOCHCALLBACK)(const nmeaINFO *info, void *arg);
+
+/**
+ * Epoch assembler: groups the sentences of a receiver cycle (GGA, GSA, GSV,
+ * RMC and VTG for the same UTC time) and publishes them as a single consistent
+ * nmeaINFO, instead of merging every sentence into an nmeaINFO that is read
+ * while it is half-updated. Uses the callbacks of its parser.
+ */
+typedef struct _nmeaEPOCH {
+	nmeaPARSER parser;				/**< The parser that feeds the assembler */
+	nmeaINFO info;					/**< The information of the epoch that is being assembled */
+	nmeaINFOMERGE merge;			/**< The merge of the sentences into info, with its GSV cycle */
+
+	uint32_t close;					/**< The rules that close an epoch (see nmeaEPOCH_CLOSE) */
+	int expected;					/**< The sentence types (see nmeaPACKTYPE) that complete an epoch */
+	uint32_t timeout;				/**< The time without sentences that closes an epoch */
+	nmeaEPOCHCALLBACK callback;		/**< The epoch callback */
+	void *arg;						/**< The argument for the epoch callback */
+
+	int received;					/**< The sentence types that were received in the epoch */
+	bool has_time;					/**< True when the epoch has a UTC time */
+	nmeaTIME utc;					/**< The UTC time of the epoch (just time) */
+	uint32_t now;					/**< The time of the nmea_epoch_parse call */
+	uint32_t last;					/**< The time at which the last sentence was received */
+	int epochs;						/**< The number of epochs that were published */
+} nmeaEPOCH;
+
+void nmea_epoch_init(nmeaEPOCH *epoch, const uint32_t close, const int expected, const uint32_t timeout,
+		nmeaEPOCHCALLBACK callback, void *arg);
+int nmea_epoch_parse(nmeaEPOCH *epoch, const char *s, const int len, const uint32_t now);
+bool nmea_epoch_poll(nmeaEPOCH *epoch, const uint32_t now);
+bool nmea_epoch_close(nmeaEPOCH *epoch);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEA_EPOCH_H__ */
@@ -0,0 +1,85 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NMEA_ERROR_H__
+#define __NMEA_ERROR_H__
+
+#include <nmea/nmeaconf.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if (NMEA_ERROR_RING_SIZE < 2) || (NMEA_ERROR_RING_SIZE & (NMEA_ERROR_RING_SIZE - 1))
+#error "NMEA_ERROR_RING_SIZE must be a power of 2"
+#endif
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * The decode errors, the value of an error record is given per code
+ */
+enum nmeaERRORCODE {
+	PARSE_ERROR_NONE = 0,
+	PARSE_ERROR_TOKENS,			/**< Too few fields or a malformed field, value: the number of fields */
+	PARSE_ERROR_TIME_FORMAT,	/**< Invalid time format, value: the length of the field */
+	PARSE_ERROR_DATE_FORMAT,	/**< Invalid date format, value: the date */
+	PARSE_ERROR_TIME,			/**< Invalid time, value: hhmmss */
+	PARSE_ERROR_DATE,			/**< Invalid date, value: ddmmyy */
+	PARSE_ERROR_DIRECTION,		/**< Invalid north/south or east/west, value: the character */
+	PARSE_ERROR_MODE,			/**< Invalid mode, value: the character */
+	PARSE_ERROR_STATUS,			/**< Invalid status, value: the character */
+	PARSE_ERROR_UNIT,			/**< Invalid unit, value: the character */
+	PARSE_ERROR_SIGNAL,			/**< Invalid GPS quality indicator, value: the indicator */
+	PARSE_ERROR_SYSTEM,			/**< Invalid system ID, value: the ID */
+	PARSE_ERROR_FIX_MODE,		/**< Invalid fix mode, value: the character */
+	PARSE_ERROR_FIX_TYPE,		/**< Invalid fix type, value: the type */
+	PARSE_ERROR_PACK,			/**< Inconsistent GSV pack, value: count << 16 | index << 8 | satellites */
+	PARSE_ERROR_SAT_ID,			/**< Invalid satellite ID, value: the ID */
+	PARSE_ERROR_SAT_ELEVATION,	/**< Invalid satellite elevation, value: the elevation */
+	PARSE_ERROR_SAT_AZIMUTH,	/**< Invalid satellite azimuth, value: the azimuth */
+	PARSE_ERROR_SAT_SNR,		/**< Invalid satellite signal strength, value: the SNR */
+	PARSE_ERROR_LAST
+};
+
+/**
+ * An error record
+ */
+typedef struct _nmeaERROR {
+	uint8_t code;				/**< The error (see nmeaERRORCODE) */
+	uint8_t type;				/**< The sentence type (see nmeaPACKTYPE) */
+	uint8_t field;				/**< The index of the offending field (0 is the address field) */
+	uint8_t reserved;			/**< Reserved */
+	int32_t value;				/**< The offending value */
+} nmeaERROR;
+
+void nmea_error_record(const enum nmeaERRORCODE code, const int type, const int field, const int32_t value);
+
+bool nmea_error_pop(nmeaERROR *error);
+uint32_t nmea_error_dropped(void);
+
+const char * nmea_error_string(const enum nmeaERRORCODE code);
+int nmea_error_format(const nmeaERROR *error, char *buf, const size_t size);
+int nmea_error_flush(void);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEA_ERROR_H__ */
@@ -21,17 +21,47 @@
 #include <nmea/info.h>
 #include <nmea/nmeaconf.h>
 
-#define NMEA_TUD_YARDS              (1.0936133)                     /**< Yards, meter * NMEA_TUD_YARDS = yard */
-#define NMEA_TUD_KNOTS              (1.852)                         /**< Knots, kilometer / NMEA_TUD_KNOTS = knot */
-#define NMEA_TUD_MILES              (1.609344)                      /**< Miles, kilometer / NMEA_TUD_MILES = mile */
-#define NMEA_TUS_MS                 (3.6)                           /**< Meters per seconds, (k/h) / NMEA_TUS_MS= (m/s) */
-#define NMEA_PI                     (3.141592653589793)             /**< PI value */
+/**
+ * @file
+ * Accuracy of the single precision build (NMEA_SINGLE_PRECISION) versus the
+ * double build. Maximum errors, in meters on the earth's surface, over random
+ * positions with |lat| <= 80 degrees. Every function gets the same (float)
+ * inputs in both builds, so the table shows the error of the function itself;
+ * the first rows show what storing a position in a float costs by itself.
+ * The budget is 1 m, functions marked with * exceed it and need double (or
+ * double-float) compensation when that budget must be met. make accuracy
+ * regenerates the table (bench/accuracy.c).
+ <pre>
+ function                       1 m - 1 km   1 - 100 km   100 - 10000 km
+ float storage of NDEG             1.81 m *   (up to 0.9 m for NDEG < 16384)
+ float storage of degrees          0.85 m
+ float storage of radians          0.76 m
+ nmea_atof (ddmm.mmmmm)            1.81 m *   (the storage error, 1 ulp at most)
+ nmea_ndeg2degree                  1.93 m *
+ nmea_degree2ndeg                  1.81 m *
+ nmea_degree2radian                0.91 m
+ nmea_distance (haversine)         0.76 m        0.76 m        2.42 m *
+ nmea_distance_ellipsoid           3.84 m *      6.96 m *      1191 m *
+ nmea_move_horz                    2.59 m *      3.53 m *     85.68 m *
+ nmea_move_horz_ellipsoid          2.16 m *      7.36 m *      8.72 m *
+ nmea_calc_pdop                 relative error 1.1e-07
+ </pre>
+ * In the single precision build nmea_distance uses the haversine formula,
+ * the spherical law of cosines that the double build uses is off by up to
+ * 3 km for short distances in float.
+ */
+
+#define NMEA_TUD_YARDS              NMEA_FLOAT(1.0936133)           /**< Yards, meter * NMEA_TUD_YARDS = yard */
+#define NMEA_TUD_KNOTS              NMEA_FLOAT(1.852)               /**< Knots, kilometer / NMEA_TUD_KNOTS = knot */
+#define NMEA_TUD_MILES              NMEA_FLOAT(1.609344)            /**< Miles, kilometer / NMEA_TUD_MILES = mile */
+#define NMEA_TUS_MS                 NMEA_FLOAT(3.6)                 /**< Meters per seconds, (k/h) / NMEA_TUS_MS= (m/s) */
+#define NMEA_PI                     NMEA_FLOAT(3.141592653589793)   /**< PI value */
 #define NMEA_PI180                  (NMEA_PI / 180)                 /**< PI division by 180 */
 #define NMEA_EARTHRADIUS_KM         (6378)                          /**< Earth's mean radius in km */
 #define NMEA_EARTHRADIUS_M          (NMEA_EARTHRADIUS_KM * 1000)    /**< Earth's mean radius in m */
-#define NMEA_EARTH_SEMIMAJORAXIS_M  (6378137.0)                     /**< Earth's semi-major axis in m according WGS84 */
+#define NMEA_EARTH_SEMIMAJORAXIS_M  NMEA_FLOAT(6378137.0)           /**< Earth's semi-major axis in m according WGS84 */
 #define NMEA_EARTH_SEMIMAJORAXIS_KM (NMEA_EARTHMAJORAXIS_KM / 1000) /**< Earth's semi-major axis in km according WGS 84 */
-#define NMEA_EARTH_FLATTENING       (1 / 298.257223563)             /**< Earth's flattening according WGS 84 */
+#define NMEA_EARTH_FLATTENING       NMEA_FLOAT(1 / 298.257223563)   /**< Earth's flattening according WGS 84 */
 #define NMEA_DOP_FACTOR             (5)                             /**< Factor for translating DOP to meters */
 
 #ifdef  __cplusplus
@@ -42,26 +72,36 @@ extern "C" {
  * degree VS radian
  */
 
-double nmea_degree2radian(const double val);
-double nmea_radian2degree(const double val);
+nmeaFLOAT nmea_degree2radian(const nmeaFLOAT val);
+nmeaFLOAT nmea_radian2degree(const nmeaFLOAT val);
 
 /*
  * NDEG (NMEA degree)
  */
 
-double nmea_ndeg2degree(const double val);
-double nmea_degree2ndeg(const double val);
+nmeaFLOAT nmea_ndeg2degree(const nmeaFLOAT val);
+nmeaFLOAT nmea_degree2ndeg(const nmeaFLOAT val);
+
+nmeaFLOAT nmea_ndeg2radian(const nmeaFLOAT val);
+nmeaFLOAT nmea_radian2ndeg(const nmeaFLOAT val);
+
+#if NMEA_FIXED_POINT
+/*
+ * fixed point coordinates (see nmeaCOORD)
+ */
 
-double nmea_ndeg2radian(const double val);
-double nmea_radian2ndeg(const double val);
+nmeaCOORD nmea_ndeg2coord(const int64_t val);
+nmeaFLOAT nmea_coord2degree(const nmeaCOORD val);
+nmeaCOORD nmea_degree2coord(const nmeaFLOAT val);
+#endif
 
 /*
  * DOP
  */
 
-double nmea_calc_pdop(const double hdop, const double vdop);
-double nmea_dop2meters(const double dop);
-double nmea_meters2dop(const double meters);
+nmeaFLOAT nmea_calc_pdop(const nmeaFLOAT hdop, const nmeaFLOAT vdop);
+nmeaFLOAT nmea_dop2meters(const nmeaFLOAT dop);
+nmeaFLOAT nmea_meters2dop(const nmeaFLOAT meters);
 
 /*
  * positions work
@@ -70,15 +110,15 @@ double nmea_meters2dop(const double meters);
 void nmea_info2pos(const nmeaINFO *info, nmeaPOS *pos);
 void nmea_pos2info(const nmeaPOS *pos, nmeaINFO *info);
 
-double nmea_distance(const nmeaPOS *from_pos, const nmeaPOS *to_pos);
+nmeaFLOAT nmea_distance(const nmeaPOS *from_pos, const nmeaPOS *to_pos);
 
-double nmea_distance_ellipsoid(const nmeaPOS *from_pos, const nmeaPOS *to_pos, double *from_azimuth,
-		double *to_azimuth);
+nmeaFLOAT nmea_distance_ellipsoid(const nmeaPOS *from_pos, const nmeaPOS *to_pos, nmeaFLOAT *from_azimuth,
+		nmeaFLOAT *to_azimuth);
 
-int nmea_move_horz(const nmeaPOS *start_pos, nmeaPOS *end_pos, double azimuth, double distance);
+int nmea_move_horz(const nmeaPOS *start_pos, nmeaPOS *end_pos, nmeaFLOAT azimuth, nmeaFLOAT distance);
 
-int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, double azimuth, double distance,
-		double *end_azimuth);
+int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, nmeaFLOAT azimuth, nmeaFLOAT distance,
+		nmeaFLOAT *end_azimuth);
 
 #ifdef  __cplusplus
 }
@@ -19,8 +19,6 @@
 #define __NMEA_INFO_H__
 
 #include <nmea/nmeaconf.h>
-#include "ch.h"
-#include "hal.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -72,9 +70,15 @@
 #define NMEA_FIX_3D    (3)
 #define NMEA_FIX_LAST  (NMEA_FIX_3D)
 
-#define NMEA_MAXSAT    (12)
-#define NMEA_SATINPACK (4)
-#define NMEA_NSATPACKS (NMEA_MAXSAT / NMEA_SATINPACK)
+#define NMEA_SATINPACK (4)                /**< Satellites in a GSV sentence */
+#define NMEA_NSATPACKS (9)                /**< GSV sentences in a cycle, at most */
+#define NMEA_SATINGSA  (12)               /**< Satellites in a GSA sentence */
+#define NMEA_SATINDEX  (NMEA_MAXSAT * 2)  /**< Slots in the satellite index of nmeaSATINFO */
+#define NMEA_SATWORDS  ((NMEA_MAXSAT + 31) / 32) /**< Words in the bitmaps of nmeaSATINFO */
+
+#if (NMEA_MAXSAT < 1) || (NMEA_MAXSAT > 255)
+#error "NMEA_MAXSAT must be in the range [1, 255]"
+#endif
 
 #define NMEA_DEF_LAT   (0.0)
 #define NMEA_DEF_LON   (0.0)
@@ -86,6 +90,47 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/**
+ * The types of the coordinates and measurements in nmeaINFO and in the
+ * sentence structures.
+ *
+ * By default these are nmeaFLOATs, in the units that are documented with the
+ * fields. When NMEA_FIXED_POINT is enabled they are scaled integers that are
+ * parsed directly from the sentence, which avoids all (soft-float) double
+ * arithmetic on the parse path and keeps the full precision of the receiver:
+ * <pre>
+ * type          fields                     unit
+ * nmeaCOORD     lat, lon                   1e-7 degrees (decimal degrees, not NDEG)
+ * nmeaLENGTH    elv, diff                  millimetres
+ * nmeaSPEED     speed, spn, spk            cm/s (also for the knots fields)
+ * nmeaANGLE     track, mtrack, magvar      1e-2 degrees
+ * nmeaDOP       PDOP, HDOP, VDOP           DOP * 100
+ * nmeaDURATION  dgps_age                   1e-2 seconds
+ * </pre>
+ */
+#if NMEA_FIXED_POINT
+typedef int32_t nmeaCOORD;
+typedef int32_t nmeaLENGTH;
+typedef int32_t nmeaSPEED;
+typedef int32_t nmeaANGLE;
+typedef int32_t nmeaDOP;
+typedef int32_t nmeaDURATION;
+
+#define NMEA_COORD_SCALE    (10000000)  /**< nmeaCOORD units per degree */
+#define NMEA_LENGTH_SCALE   (1000)      /**< nmeaLENGTH units per meter */
+#define NMEA_SPEED_SCALE    (100)       /**< nmeaSPEED units per meter per second */
+#define NMEA_ANGLE_SCALE    (100)       /**< nmeaANGLE units per degree */
+#define NMEA_DOP_SCALE      (100)       /**< nmeaDOP units per DOP */
+#define NMEA_DURATION_SCALE (100)       /**< nmeaDURATION units per second */
+#else
+typedef nmeaFLOAT nmeaCOORD;
+typedef nmeaFLOAT nmeaLENGTH;
+typedef nmeaFLOAT nmeaSPEED;
+typedef nmeaFLOAT nmeaANGLE;
+typedef nmeaFLOAT nmeaDOP;
+typedef nmeaFLOAT nmeaDURATION;
+#endif
+
 /**
  * Date and time data
  * @see nmea_time_now
@@ -104,10 +149,25 @@ typedef struct _nmeaTIME {
  * Position data in fractional degrees or radians
  */
 typedef struct _nmeaPOS {
-	double lat;						/**< Latitude */
-	double lon;						/**< Longitude */
+	nmeaFLOAT lat;					/**< Latitude */
+	nmeaFLOAT lon;					/**< Longitude */
 } nmeaPOS;
 
+/**
+ * Satellite systems, numbered by their NMEA 4.10 system IDs (QZSS and NavIC
+ * are from NMEA 4.11)
+ */
+enum nmeaSYSTEM {
+	SYSTEM_UNKNOWN = 0,	/**< Unknown system. */
+	SYSTEM_GPS = 1,		/**< GPS (and SBAS). */
+	SYSTEM_GLONASS = 2,	/**< GLONASS. */
+	SYSTEM_GALILEO = 3,	/**< Galileo. */
+	SYSTEM_BEIDOU = 4,	/**< BeiDou. */
+	SYSTEM_QZSS = 5,	/**< QZSS. */
+	SYSTEM_NAVIC = 6,	/**< NavIC (IRNSS). */
+	SYSTEM_LAST = SYSTEM_NAVIC
+};
+
 /**
  * Information about satellite
  * @see nmeaSATINFO
@@ -118,18 +178,41 @@ typedef struct _nmeaSATELLITE {
 	int elv;						/**< Elevation in degrees, 90 maximum */
 	int azimuth;					/**< Azimuth, degrees from true north, 000 to 359 */
 	int sig;						/**< Signal, 00-99 dB */
+	int system;						/**< Satellite system (see nmeaSYSTEM) */
+	int signal;						/**< Signal ID (NMEA 4.10), 0 when not reported */
 } nmeaSATELLITE;
 
 /**
- * Information about all satellites in view
+ * Identification of a satellite in use
+ * @see nmeaSATINFO
+ */
+typedef struct _nmeaSATID {
+	int system;						/**< Satellite system (see nmeaSYSTEM) */
+	int id;							/**< Satellite PRN number */
+} nmeaSATID;
+
+/**
+ * Information about all satellites in view, of all systems.
+ *
+ * The satellites in view are stored in the first inview entries of sat, in
+ * no particular order. A satellite is identified by its system, PRN and
+ * signal: a satellite that is reported for several signals has an entry per
+ * signal. The index maps (system, PRN) to entries in sat, so that finding and
+ * updating a satellite takes constant time (see nmea_INFO_sat_find). Use the
+ * nmea_INFO_sat_ functions to modify the satellites in view, or call
+ * nmea_INFO_sanitise afterwards, to keep the index consistent.
+ *
  * @see nmeaINFO
  * @see nmeaGPGSV
  */
 typedef struct _nmeaSATINFO {
 	int inuse;						/**< Number of satellites in use (not those in view) */
-	int in_use[NMEA_MAXSAT];		/**< IDs of satellites in use (not those in view) */
-	int inview;						/**< Total number of satellites in view */
+	nmeaSATID in_use[NMEA_MAXSAT];	/**< Satellites in use (not those in view) */
+	int inview;						/**< Number of satellites in view (entries in sat) */
 	nmeaSATELLITE sat[NMEA_MAXSAT]; /**< Satellites information (in view) */
+	uint8_t index[NMEA_SATINDEX];	/**< Open addressing index of sat: entry + 1, 0 when the slot is empty */
+	uint32_t changed[NMEA_SATWORDS];	/**< Entries of sat that changed, a bit per entry (see nmea_INFO_sat_is_changed) */
+	uint32_t stale[NMEA_SATWORDS];	/**< Entries of sat that are stale, a bit per entry (see nmea_INFO_sat_mark) */
 } nmeaSATINFO;
 
 /**
@@ -141,6 +224,8 @@ typedef struct _nmeaSATINFO {
 typedef struct _nmeaINFO {
 	uint32_t present;				/**< Mask specifying which fields are present */
 
+	uint32_t changed;				/**< Mask specifying which fields changed (see nmea_INFO_clear_changed) */
+
 	int smask;						/**< Mask specifying from which sentences data has been obtained */
 
 	nmeaTIME utc;					/**< UTC of position */
@@ -159,17 +244,17 @@ typedef struct _nmeaINFO {
 	                                                                          2 = 2D
 	                                                                          3 = 3D) */
 
-	double PDOP;					/**< Position Dilution Of Precision */
-	double HDOP;					/**< Horizontal Dilution Of Precision */
-	double VDOP;					/**< Vertical Dilution Of Precision */
+	nmeaDOP PDOP;					/**< Position Dilution Of Precision */
+	nmeaDOP HDOP;					/**< Horizontal Dilution Of Precision */
+	nmeaDOP VDOP;					/**< Vertical Dilution Of Precision */
 
-	double lat;						/**< Latitude in NDEG:  +/-[degree][min].[sec/60] */
-	double lon;						/**< Longitude in NDEG: +/-[degree][min].[sec/60] */
-	double elv;						/**< Antenna altitude above/below mean sea level (geoid) in meters */
-	double speed;					/**< Speed over the ground in kph */
-	double track;					/**< Track angle in degrees True */
-	double mtrack;					/**< Magnetic Track angle in degrees True */
-	double magvar;					/**< Magnetic variation degrees */
+	nmeaCOORD lat;					/**< Latitude in NDEG:  +/-[degree][min].[sec/60], in 1e-7 degrees with NMEA_FIXED_POINT (see nmeaCOORD) */
+	nmeaCOORD lon;					/**< Longitude in NDEG: +/-[degree][min].[sec/60], in 1e-7 degrees with NMEA_FIXED_POINT (see nmeaCOORD) */
+	nmeaLENGTH elv;					/**< Antenna altitude above/below mean sea level (geoid) in meters */
+	nmeaSPEED speed;				/**< Speed over the ground in kph */
+	nmeaANGLE track;				/**< Track angle in degrees True */
+	nmeaANGLE mtrack;				/**< Magnetic Track angle in degrees True */
+	nmeaANGLE magvar;				/**< Magnetic variation degrees */
 
 	nmeaSATINFO satinfo;			/**< Satellites information */
 
@@ -208,7 +293,9 @@ void nmea_INFO_set_connection(nmeaINFO *info, int connection);
 bool nmea_INFO_has_connection(nmeaINFO *info);
 bool nmea_INFO_has_fix(nmeaINFO *info);
 
+#if NMEA_PLATFORM == NMEA_PLATFORM_CHIBIOS
 void nmea_INFO2time(nmeaINFO *info, RTCDateTime *timespec, long int timezone);
+#endif
 void nmea_time_now(nmeaTIME *utc, uint32_t * present);
 void nmea_zero_INFO(nmeaINFO *info);
 
@@ -217,6 +304,17 @@ bool nmea_INFO_is_present(uint32_t present, nmeaINFO_FIELD fieldName);
 void nmea_INFO_set_present(uint32_t * present, nmeaINFO_FIELD fieldName);
 void nmea_INFO_unset_present(uint32_t * present, nmeaINFO_FIELD fieldName);
 
+void nmea_INFO_clear_changed(nmeaINFO *info);
+bool nmea_INFO_is_changed(const nmeaINFO *info, nmeaINFO_FIELD fieldName);
+bool nmea_INFO_sat_is_changed(const nmeaSATINFO *satinfo, const int entry);
+
+int nmea_INFO_sat_system(const int id);
+nmeaSATELLITE * nmea_INFO_sat_find(nmeaSATINFO *satinfo, const int system, const int id, const int signal);
+bool nmea_INFO_sat_update(nmeaSATINFO *satinfo, const nmeaSATELLITE *sat);
+void nmea_INFO_sat_mark(nmeaSATINFO *satinfo, const int system, const int signal);
+void nmea_INFO_sat_sweep(nmeaSATINFO *satinfo, const int system, const int signal);
+bool nmea_INFO_sat_use(nmeaSATINFO *satinfo, const int system, const int *ids, const int count);
+
 void nmea_INFO_sanitise(nmeaINFO *nmeaInfo);
 
 void nmea_INFO_unit_conversion(nmeaINFO * nmeaInfo);
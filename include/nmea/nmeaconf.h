@@ -10,18 +10,106 @@
 
 #define NMEA_DEBUG 1
 
-#define NMEA_VALIDATE       1
+/**
+ * record decode errors in the error queue (see error.h), a low priority
+ * thread writes them to the error sink with nmea_error_flush
+ */
 #define NMEA_ERROR          1
 
-#include "ch.h"
-#include "hal.h"
-#include "chprintf.h"
-extern SerialUSBDriver SDU1;
+/** the number of records of the error queue, a power of 2 */
+#define NMEA_ERROR_RING_SIZE 16
+
+/**
+ * the platform (see platform.h): NMEA_PLATFORM_CHIBIOS for the firmware,
+ * NMEA_PLATFORM_POSIX for hosted builds (the Makefile defines it)
+ */
+#ifndef NMEA_PLATFORM
+#define NMEA_PLATFORM       NMEA_PLATFORM_CHIBIOS
+#endif
+
+/** the serial driver that nmea_error writes to on ChibiOS */
 #define NMEASD SDU1
-#define nmea_error(format, ...) chprintf((BaseSequentialStream *)&NMEASD, format, __VA_ARGS__)
 
 #define NMEA_TIME_FORMAT    4
 
+/**
+ * the sentences that are compiled in: their decoders (parse.h), their merges
+ * into nmeaINFO (conversions.h) and their space in nmeaPARSER. The parser
+ * counts the sentences that are left out as unknown. Can be given on the
+ * command line, make sizes reports the code and data size per selection.
+ */
+#ifndef NMEA_SENTENCE_GGA
+#define NMEA_SENTENCE_GGA   1
+#endif
+#ifndef NMEA_SENTENCE_GSA
+#define NMEA_SENTENCE_GSA   1
+#endif
+#ifndef NMEA_SENTENCE_GSV
+#define NMEA_SENTENCE_GSV   1
+#endif
+#ifndef NMEA_SENTENCE_RMC
+#define NMEA_SENTENCE_RMC   1
+#endif
+#ifndef NMEA_SENTENCE_VTG
+#define NMEA_SENTENCE_VTG   1
+#endif
+
+/**
+ * frame runs of sentence characters at once in nmea_parse instead of one by
+ * one (uses SSE2/AVX2 when the compiler targets them)
+ */
+#ifndef NMEA_BULK_SCAN
+#define NMEA_BULK_SCAN      1
+#endif
+
+/**
+ * store coordinates and measurements as scaled integers instead of doubles
+ * (see nmeaCOORD in info.h), for targets without a double precision FPU
+ */
+#ifndef NMEA_FIXED_POINT
+#define NMEA_FIXED_POINT    0
+#endif
+
+/**
+ * use float instead of double for all floating point fields, numbers and
+ * calculations (see nmeaFLOAT in info.h and the accuracy notes in gmath.h),
+ * for targets with a single precision FPU
+ */
+#ifndef NMEA_SINGLE_PRECISION
+#define NMEA_SINGLE_PRECISION 0
+#endif
+
+/**
+ * count characters, sentences and the reasons for dropping sentences in the
+ * parser (see nmea_parser_stats), plain increments
+ */
+#ifndef NMEA_PARSER_STATS
+#define NMEA_PARSER_STATS   1
+#endif
+
+/**
+ * measure the latency of every sentence in the parser, from its '$' to the end
+ * of the line and to the end of the merge into nmeaINFO (see nmea_parser_trace)
+ */
+#ifndef NMEA_PARSER_TRACE
+#define NMEA_PARSER_TRACE   0
+#endif
+
+/**
+ * the clock of the parser latency measurements, a free running 32-bit tick
+ * counter (see nmea_platform_ticks in platform.h)
+ */
+#define NMEA_TRACE_CLOCK()  nmea_platform_ticks()
+
+/**
+ * the bound in ticks of NMEA_TRACE_CLOCK for processing a sentence (from its
+ * line feed to the end of the merge), the sentences that exceed it are counted
+ * per type (see nmeaPARSERTRACE), 0 disables the check
+ */
+#ifndef NMEA_TRACE_BOUND
+#define NMEA_TRACE_BOUND    0
+#endif
+
 /** the default size for the temporary buffers */
 #define NMEA_DEF_PARSEBUFF  128
 
@@ -34,13 +122,51 @@ extern SerialUSBDriver SDU1;
 /** number conversion buffer size */
 #define NMEA_CONVSTR_BUF    32
 
+/** the maximum number of fields in a sentence (including the address field) */
+#define NMEA_MAXFIELDS      24
+
+/**
+ * the capacity of the satellite store (see nmeaSATINFO in info.h): the number
+ * of satellites in view of all systems, counting each reported signal of a
+ * satellite separately (at most 255)
+ */
+#define NMEA_MAXSAT         64
+
+/**
+ * what to do with a cycle of GSV sentences of which messages are missing when
+ * it is abandoned (see nmea_GPGSV2cycle): 1 updates the satellites of the
+ * messages that were received (without removing satellites), 0 drops them
+ */
+#define NMEA_GSV_PARTIAL    1
+
 #define SENTENCE_SIZE (128)
 
-#if NMEA_DEBUG
-  #include "ch.h"
-  #define NMEA_ASSERT(x) chDbgAssert(x, "nmealib")
+/**
+ * the size of the character ring between the receiving and the parsing thread
+ * (see nmeaRING in ring.h), a power of 2: 921600 baud delivers 92 characters
+ * per millisecond
+ */
+#define NMEA_RING_SIZE      1024
+
+/**
+ * the cache line size of the target, the producer and the consumer side of a
+ * ring are kept in separate cache lines
+ */
+#define NMEA_CACHE_LINE     32
+
+/**
+ * The floating point type of the library: float when NMEA_SINGLE_PRECISION is
+ * enabled, double otherwise. NMEA_FLOAT() makes a constant of that type, so
+ * that expressions are not promoted to double.
+ */
+#if NMEA_SINGLE_PRECISION
+typedef float nmeaFLOAT;
+#define NMEA_FLOAT(x)       ((float) (x))
 #else
-  #define NMEA_ASSERT(x)
+typedef double nmeaFLOAT;
+#define NMEA_FLOAT(x)       (x)
 #endif
 
+#include <nmea/platform.h>
+
 #endif /* NMEALIB_INCLUDE_NMEA_NMEACONF_H_ */
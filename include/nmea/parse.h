@@ -22,21 +22,89 @@
 #include <nmea/sentence.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+#if NMEA_MAXFIELDS > 32
+#error "NMEA_MAXFIELDS must be at most 32 (see nmeaFIELDS)"
+#endif
 
 #ifdef  __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
+/**
+ * The validation levels of the sentence decoders (see nmea_parser_set_validation).
+ * Deriving the presence of the fields from their emptiness alone is the cheapest
+ * level, VALIDATE_NONE: a value with a hemisphere needs both fields, and a time or
+ * date that does not parse is absent. VALIDATE_STRUCTURAL adds the format checks
+ * that reject a sentence.
+ */
+enum nmeaVALIDATION {
+	VALIDATE_NONE = 0,		/**< The fields that are not empty are present (with their hemisphere), a malformed time or date is absent, without rejecting the sentence: for trusted receivers */
+	VALIDATE_STRUCTURAL,	/**< Determine the presence of the fields from their emptiness and reject the sentences with a malformed format (time, date, the direction or unit of a value), without checking their values */
+	VALIDATE_FULL			/**< Determine the presence of the fields and check their values, absent fields are marked (-1, NaN) in the sentence structures */
+};
+
+/**
+ * A field of a sentence: a slice of the sentence string
+ * @see nmeaFIELDS
+ */
+typedef struct _nmeaFIELD {
+	uint8_t offset;					/**< Offset of the field from the start of the sentence */
+	uint8_t length;					/**< Length of the field, 0 when empty */
+} nmeaFIELD;
+
+/**
+ * The comma separated fields of a sentence.
+ * Field 0 is the address field ('$' followed by the header), the last field
+ * ends at the '*' that precedes the checksum.
+ * @see nmea_parse_fields
+ */
+typedef struct _nmeaFIELDS {
+	int count;						/**< Number of fields, including the address field */
+	uint32_t nonempty;				/**< Bit i is set when field i is not empty */
+	nmeaFIELD field[NMEA_MAXFIELDS];	/**< The fields */
+} nmeaFIELDS;
+
 char isInvalidNMEACharacter(const char * c);
 char nmea_parse_sentence_has_invalid_chars(const char * s, const size_t len);
 
+enum nmeaTALKER nmea_parse_get_talker(const char *s, const int len);
 enum nmeaPACKTYPE nmea_parse_get_sentence_type(const char *s, const int len);
 
+int nmea_parse_fields(const char *s, const int len, nmeaFIELDS *fields);
+const char * nmea_parse_field(const char *s, const nmeaFIELDS *fields, const int index, int *len);
+
+
+#if NMEA_SENTENCE_GGA
+int nmea_parse_GPGGA_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPGGA *pack);
 int nmea_parse_GPGGA(const char *s, const int len, bool has_checksum, nmeaGPGGA *pack);
+#endif
+
+#if NMEA_SENTENCE_GSA
+int nmea_parse_GPGSA_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPGSA *pack);
 int nmea_parse_GPGSA(const char *s, const int len, bool has_checksum, nmeaGPGSA *pack);
+#endif
+
+#if NMEA_SENTENCE_GSV
+int nmea_parse_GPGSV_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPGSV *pack);
 int nmea_parse_GPGSV(const char *s, const int len, bool has_checksum, nmeaGPGSV *pack);
+#endif
+
+#if NMEA_SENTENCE_RMC
+int nmea_parse_GPRMC_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPRMC *pack);
 int nmea_parse_GPRMC(const char *s, const int len, bool has_checksum, nmeaGPRMC *pack);
+#endif
+
+#if NMEA_SENTENCE_VTG
+int nmea_parse_GPVTG_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPVTG *pack);
 int nmea_parse_GPVTG(const char *s, const int len, bool has_checksum, nmeaGPVTG *pack);
+#endif
 
 #ifdef  __cplusplus
 }
@@ -20,17 +20,26 @@
 
 #include <nmea/info.h>
 #include <nmea/nmeaconf.h>
+#include <nmea/parse.h>
 #include <nmea/sentence.h>
 
+#if !(NMEA_SENTENCE_GGA || NMEA_SENTENCE_GSA || NMEA_SENTENCE_GSV || NMEA_SENTENCE_RMC || NMEA_SENTENCE_VTG)
+#error "at least one of the NMEA_SENTENCE_* options must be enabled"
+#endif
+
 #ifdef  __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
 typedef enum _sentence_parser_state {
   SKIP_UNTIL_START,
+  READ_HEADER,      /**< reading the header, up to NMEA_HEADER_SIZE characters (see nmea_parser_set_filter) */
   READ_SENTENCE,
-  READ_CHECKSUM,
-  READ_EOL
+  READ_CHECKSUM,    /**< expecting the first checksum digit */
+  READ_CHECKSUM_LO, /**< expecting the second checksum digit */
+  READ_EOL,         /**< expecting the CR */
+  READ_EOL_LF,      /**< expecting the LF */
+  SENTENCE_PARSER_STATES
 } sentence_parser_state;
 
 /**
@@ -40,16 +49,107 @@ typedef struct _sentencePARSER {
     int sentence_checksum;
     int calculated_checksum;
 
-    char sentence_checksum_chars[2];
-    char sentence_checksum_chars_count;
-
-    char sentence_eol_chars_count;
-
     bool has_checksum;
 
     sentence_parser_state state;
 } sentencePARSER;
 
+/** the size of the start of a sentence that the filter looks at: '$', the talker and the formatter */
+#define NMEA_HEADER_SIZE (6)
+
+/** the bit of a talker (see nmeaTALKER) in the talker mask of the filter (see nmea_parser_set_filter) */
+#define NMEA_TALKER_BIT(talker) (1u << (talker))
+
+/** the number of sentence types that callbacks can be registered for */
+#define NMEA_PARSER_CALLBACKS (5)
+
+/**
+ * A sentence callback, called by nmea_parse for every decoded sentence of the
+ * type that it was registered for (see nmea_parser_set_callback), before the
+ * sentence is merged into the nmeaINFO structure.
+ *
+ * @param type the sentence type
+ * @param pack a pointer to the decoded sentence (nmeaGPGGA, nmeaGPGSA, ...
+ * depending on the type), valid during the call only
+ * @param s the raw sentence, from the '$' up to and including the line feed
+ * (not NUL-terminated), valid during the call only
+ * @param len the length of the raw sentence
+ * @param arg the argument that was registered with the callback
+ */
+typedef void (*nmeaCALLBACK)(const enum nmeaPACKTYPE type, const void *pack, const char *s, const int len, void *arg);
+
+/**
+ * The argument of nmea_parser_info_callback: the nmeaINFO structure into which
+ * the sentences are merged and the cycle in which the GSV sentences are
+ * assembled, so that the satellites of a cycle are merged at once like
+ * nmea_parse does (see nmea_parser_info_merge_init)
+ */
+typedef struct _nmeaINFOMERGE {
+    nmeaINFO *info;                                /**< The nmeaINFO structure */
+#if NMEA_SENTENCE_GSV
+    nmeaGSVCYCLE gsv_cycle;                        /**< The GSV cycle in progress */
+#endif
+} nmeaINFOMERGE;
+
+/**
+ * Parser statistics (see nmea_parser_stats), counted when NMEA_PARSER_STATS
+ * is enabled. The per-type counters are in the order GGA, GSA, GSV, RMC, VTG.
+ */
+typedef struct _nmeaPARSERSTATS {
+    uint32_t bytes;                                /**< characters fed to the parser */
+    uint32_t skipped;                              /**< characters outside sentences (waiting for a '$') */
+    uint32_t framed;                               /**< sentences framed with a valid (or without a) checksum */
+    uint32_t max_length;                           /**< the length of the longest framed sentence */
+    uint32_t sentences[NMEA_PARSER_CALLBACKS];     /**< sentences decoded, per type */
+    uint32_t rejected[NMEA_PARSER_CALLBACKS];      /**< sentences rejected by the decoder, per type */
+    uint32_t unknown;                              /**< sentences of an unsupported type */
+    uint32_t filtered;                             /**< sentences skipped after their header (see nmea_parser_set_filter) */
+    uint32_t no_checksum;                          /**< sentences dropped for lack of a checksum */
+    uint32_t checksum;                             /**< sentences dropped on a checksum mismatch */
+    uint32_t overflow;                             /**< sentences dropped because they do not fit in the buffer */
+    uint32_t invalid;                              /**< sentences dropped on an invalid character or malformed framing */
+    uint32_t interrupted;                          /**< sentences dropped because a next one started */
+} nmeaPARSERSTATS;
+
+/** the number of buckets of a latency histogram */
+#define NMEA_TRACE_BUCKETS (32)
+
+/**
+ * A latency histogram in clock ticks (see NMEA_TRACE_CLOCK). Bucket k counts
+ * the latencies from 2^k up to 2^(k+1) ticks (bucket 0 includes 0).
+ */
+typedef struct _nmeaLATENCY {
+    uint32_t count;                                /**< the number of latencies */
+    uint32_t min;                                  /**< the lowest latency */
+    uint32_t max;                                  /**< the highest latency */
+    uint64_t sum;                                  /**< the sum of the latencies */
+    uint32_t buckets[NMEA_TRACE_BUCKETS];          /**< the histogram */
+} nmeaLATENCY;
+
+/**
+ * Parser latency measurements (see nmea_parser_trace), taken when
+ * NMEA_PARSER_TRACE is enabled. The timestamps are taken when the parser
+ * handles the characters, so the receive latency covers the time between the
+ * calls of nmea_parse that delivered the sentence. The per-type histograms
+ * are in the order GGA, GSA, GSV, RMC, VTG.
+ */
+typedef struct _nmeaPARSERTRACE {
+    uint32_t start;                                /**< the timestamp of the '$' of the current sentence */
+    uint32_t eol;                                  /**< the timestamp of the line feed of the current sentence */
+    nmeaLATENCY receive[NMEA_PARSER_CALLBACKS];    /**< from the '$' to the line feed, per type */
+    nmeaLATENCY process[NMEA_PARSER_CALLBACKS];    /**< from the line feed to the end of the merge, per type */
+    nmeaLATENCY total[NMEA_PARSER_CALLBACKS];      /**< from the '$' to the end of the merge, per type */
+    uint32_t exceeded[NMEA_PARSER_CALLBACKS];      /**< the number of sentences that took longer than NMEA_TRACE_BOUND to process, per type */
+} nmeaPARSERTRACE;
+
+/**
+ * A segment of a string (see nmea_parse_segments)
+ */
+typedef struct _nmeaSEGMENT {
+    const char *s; /**< the start of the segment */
+    int len;       /**< the length of the segment */
+} nmeaSEGMENT;
+
 /**
  * parsed NMEA data and frame parser state
  */
@@ -60,18 +160,73 @@ typedef struct _nmeaPARSER {
     } buffer;
 
     union {
+#if NMEA_SENTENCE_GGA
         nmeaGPGGA gpgga;
+#endif
+#if NMEA_SENTENCE_GSA
         nmeaGPGSA gpgsa;
+#endif
+#if NMEA_SENTENCE_GSV
         nmeaGPGSV gpgsv;
+#endif
+#if NMEA_SENTENCE_RMC
         nmeaGPRMC gprmc;
+#endif
+#if NMEA_SENTENCE_VTG
         nmeaGPVTG gpvtg;
+#endif
     } sentence;
 
+    nmeaFIELDS fields;
+
+    enum nmeaVALIDATION validation;
+
+    struct {
+        int types;
+        uint32_t talkers;
+    } filter;
+
+#if NMEA_SENTENCE_GSV
+    nmeaGSVCYCLE gsv_cycle;
+#endif
+
     sentencePARSER sentence_parser;
+
+    struct {
+        nmeaCALLBACK function;
+        void *arg;
+    } callbacks[NMEA_PARSER_CALLBACKS];
+
+#if NMEA_PARSER_STATS
+    nmeaPARSERSTATS stats;
+#endif
+
+#if NMEA_PARSER_TRACE
+    nmeaPARSERTRACE trace;
+#endif
 } nmeaPARSER;
 
 int nmea_parser_init(nmeaPARSER *parser);
+void nmea_parser_set_validation(nmeaPARSER *parser, const enum nmeaVALIDATION validation);
+void nmea_parser_set_filter(nmeaPARSER *parser, const int types, const uint32_t talkers);
 int nmea_parse(nmeaPARSER * parser, const char * s, int len, nmeaINFO * info);
+int nmea_parse_segments(nmeaPARSER * parser, const nmeaSEGMENT * segments, int count, nmeaINFO * info);
+
+bool nmea_parser_set_callback(nmeaPARSER *parser, const enum nmeaPACKTYPE type, nmeaCALLBACK function, void *arg);
+void nmea_parser_info_merge_init(nmeaINFOMERGE *merge, nmeaINFO *info);
+void nmea_parser_info_callback(const enum nmeaPACKTYPE type, const void *pack, const char *s, const int len, void *arg);
+
+void nmea_parser_stats(const nmeaPARSER *parser, nmeaPARSERSTATS *stats);
+void nmea_parser_reset_stats(nmeaPARSER *parser);
+
+#if NMEA_PARSER_TRACE
+const nmeaPARSERTRACE * nmea_parser_trace(const nmeaPARSER *parser);
+void nmea_parser_reset_trace(nmeaPARSER *parser);
+uint32_t nmea_latency_percentile(const nmeaLATENCY *latency, const unsigned int percent);
+#endif
+
+const nmeaFIELDS * nmea_parser_fields(const nmeaPARSER *parser);
+const char * nmea_parser_field(const nmeaPARSER *parser, const int index, int *len);
 
 #ifdef  __cplusplus
 }
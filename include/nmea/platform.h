@@ -0,0 +1,97 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NMEA_PLATFORM_H__
+#define __NMEA_PLATFORM_H__
+
+/**
+ * @file
+ * The platform layer: the tick clock (nmea_platform_ticks), the date and time
+ * of the real-time clock (nmea_platform_time), the error sink (nmea_error) and
+ * NMEA_ASSERT. Included by nmeaconf.h, the platform is selected there with
+ * NMEA_PLATFORM.
+ */
+
+#define NMEA_PLATFORM_CHIBIOS 1 /**< ChibiOS/HAL: realtime counter, RTCD1, chprintf to NMEASD, chDbgAssert */
+#define NMEA_PLATFORM_POSIX   2 /**< POSIX: CLOCK_MONOTONIC, CLOCK_REALTIME, stderr, assert */
+
+#include <stdint.h>
+#include <time.h>
+
+#if NMEA_PLATFORM == NMEA_PLATFORM_CHIBIOS
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+extern SerialUSBDriver NMEASD;
+
+#define nmea_error(format, ...) chprintf((BaseSequentialStream *)&NMEASD, format, __VA_ARGS__)
+
+#if NMEA_DEBUG
+  #define NMEA_ASSERT(x) chDbgAssert(x, "nmealib")
+#else
+  #define NMEA_ASSERT(x)
+#endif
+
+/**
+ * @return the ticks of a free running 32-bit clock, the realtime counter (the
+ * DWT cycle counter on Cortex-M)
+ */
+static inline uint32_t nmea_platform_ticks(void) {
+  return (uint32_t) chSysGetRealtimeCounterX();
+}
+
+#elif NMEA_PLATFORM == NMEA_PLATFORM_POSIX
+
+#include <assert.h>
+#include <stdio.h>
+
+#define nmea_error(format, ...) fprintf(stderr, format, __VA_ARGS__)
+
+#if NMEA_DEBUG
+  #define NMEA_ASSERT(x) assert(x)
+#else
+  #define NMEA_ASSERT(x)
+#endif
+
+/**
+ * @return the ticks of a free running 32-bit clock, nanoseconds of the
+ * monotonic clock
+ */
+static inline uint32_t nmea_platform_ticks(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t) (((uint64_t) now.tv_sec * 1000000000u) + (uint64_t) now.tv_nsec);
+}
+
+#else
+#error "NMEA_PLATFORM must be NMEA_PLATFORM_CHIBIOS or NMEA_PLATFORM_POSIX"
+#endif
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+void nmea_platform_time(struct tm *tm, uint32_t *msec);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEA_PLATFORM_H__ */
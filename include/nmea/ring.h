@@ -0,0 +1,79 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NMEA_RING_H__
+#define __NMEA_RING_H__
+
+#include <nmea/info.h>
+#include <nmea/nmeaconf.h>
+#include <nmea/parser.h>
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if (NMEA_RING_SIZE < 2) || (NMEA_RING_SIZE & (NMEA_RING_SIZE - 1))
+#error "NMEA_RING_SIZE must be a power of 2"
+#endif
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Single-producer/single-consumer byte ring between the thread (or interrupt
+ * handler) that receives the characters and the thread that parses them (see
+ * nmea_parse_ring). Lock-free: the producer never waits for the consumer,
+ * characters that do not fit are dropped and counted instead.
+ *
+ * The indices run freely and are masked on use. Each side owns a cache line
+ * with its own index and a copy of the index of the other side, so that the
+ * sides only touch each other's line when the copy runs out.
+ */
+typedef struct _nmeaRING {
+	struct {
+		_Alignas(NMEA_CACHE_LINE) atomic_uint head;	/**< The write index, published to the consumer */
+		unsigned int tail;							/**< The last read index that the producer saw */
+		atomic_uint overruns;						/**< The number of writes that did not fit (completely) */
+		atomic_uint dropped;						/**< The number of characters that were dropped */
+	} producer;
+
+	struct {
+		_Alignas(NMEA_CACHE_LINE) atomic_uint tail;	/**< The read index, published to the producer */
+		unsigned int head;							/**< The last write index that the consumer saw */
+	} consumer;
+
+	_Alignas(NMEA_CACHE_LINE) char buffer[NMEA_RING_SIZE];	/**< The characters */
+} nmeaRING;
+
+void nmea_ring_init(nmeaRING *ring);
+
+size_t nmea_ring_write(nmeaRING *ring, const char *s, size_t len);
+
+size_t nmea_ring_pending(nmeaRING *ring);
+size_t nmea_ring_peek(nmeaRING *ring, const char **s);
+void nmea_ring_consume(nmeaRING *ring, size_t len);
+
+void nmea_ring_counters(nmeaRING *ring, unsigned int *overruns, unsigned int *dropped);
+
+int nmea_parse_ring(nmeaPARSER * parser, nmeaRING * ring, nmeaINFO * info);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEA_RING_H__ */
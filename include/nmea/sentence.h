@@ -43,6 +43,20 @@ enum nmeaPACKTYPE {
 	GPVTG = (1u << 4)	/**< VTG - Actual track made good and speed over ground. */
 };
 
+/**
+ * Talkers (the first two characters of the header) of which the sentences
+ * are parsed. The sentence type (see nmeaPACKTYPE) does not depend on it.
+ */
+enum nmeaTALKER {
+	TALKER_NONE = 0,	/**< Unknown talker. */
+	TALKER_GP,			/**< GP - GPS. */
+	TALKER_GN,			/**< GN - Combined GNSS solution (multiple systems). */
+	TALKER_GL,			/**< GL - GLONASS. */
+	TALKER_GA,			/**< GA - Galileo. */
+	TALKER_GB,			/**< GB or BD - BeiDou. */
+	TALKER_GQ			/**< GQ - QZSS. */
+};
+
 /**
  * GGA packet information structure (Global Positioning System Fix Data)
  *
@@ -83,18 +97,18 @@ enum nmeaPACKTYPE {
 typedef struct _nmeaGPGGA {
 	uint32_t present;			/**< Mask specifying which fields are present, same as in nmeaINFO */
 	nmeaTIME utc;				/**< UTC of position (just time) */
-	double lat;					/**< Latitude in NDEG - [degree][min].[sec/60] */
+	nmeaCOORD lat;				/**< Latitude in NDEG - [degree][min].[sec/60], in 1e-7 degrees with NMEA_FIXED_POINT */
 	char ns;					/**< [N]orth or [S]outh */
-	double lon;					/**< Longitude in NDEG - [degree][min].[sec/60] */
+	nmeaCOORD lon;				/**< Longitude in NDEG - [degree][min].[sec/60], in 1e-7 degrees with NMEA_FIXED_POINT */
 	char ew;					/**< [E]ast or [W]est */
 	int sig;					/**< GPS quality indicator (0 = Invalid; 1 = Fix; 2 = Differential, 3 = Sensitive) */
 	int satinuse;				/**< Number of satellites in use (not those in view) */
-	double HDOP;				/**< Horizontal dilution of precision */
-	double elv;					/**< Antenna altitude above/below mean sea level (geoid) */
+	nmeaDOP HDOP;				/**< Horizontal dilution of precision */
+	nmeaLENGTH elv;				/**< Antenna altitude above/below mean sea level (geoid) */
 	char elv_units;				/**< [M]eters (Antenna height unit) */
-	double diff;				/**< Geoidal separation (Diff. between WGS-84 earth ellipsoid and mean sea level. '-' = geoid is below WGS-84 ellipsoid) */
+	nmeaLENGTH diff;			/**< Geoidal separation (Diff. between WGS-84 earth ellipsoid and mean sea level. '-' = geoid is below WGS-84 ellipsoid) */
 	char diff_units;			/**< [M]eters (Units of geoidal separation) */
-	double dgps_age;			/**< Time in seconds since last DGPS update */
+	nmeaDURATION dgps_age;		/**< Time in seconds since last DGPS update */
 	int dgps_sid;				/**< DGPS station ID number */
 } nmeaGPGGA;
 
@@ -137,16 +151,20 @@ typedef struct _nmeaGPGGA {
  *      1.3      Horizontal dilution of precision (HDOP)
  *      2.1      Vertical dilution of precision (VDOP)
  *      *39      the checksum data, always begins with *
+ *
+ * NMEA 4.10 adds the system ID (see nmeaSYSTEM) of the PRNs after the VDOP.
+ * A receiver that uses several systems sends a GNGSA sentence per system.
  * </pre>
  */
 typedef struct _nmeaGPGSA {
 	uint32_t present;			/**< Mask specifying which fields are present, same as in nmeaINFO */
 	char fix_mode;				/**< Mode (M = Manual, forced to operate in 2D or 3D; A = Automatic, 3D/2D) */
 	int fix_type;				/**< Type, used for navigation (1 = Fix not available; 2 = 2D; 3 = 3D) */
-	int sat_prn[NMEA_MAXSAT];	/**< PRNs of satellites used in position fix (0 for unused fields) */
-	double PDOP;				/**< Dilution of precision */
-	double HDOP;				/**< Horizontal dilution of precision */
-	double VDOP;				/**< Vertical dilution of precision */
+	int sat_prn[NMEA_SATINGSA];	/**< PRNs of satellites used in position fix (0 for unused fields) */
+	nmeaDOP PDOP;				/**< Dilution of precision */
+	nmeaDOP HDOP;				/**< Horizontal dilution of precision */
+	nmeaDOP VDOP;				/**< Vertical dilution of precision */
+	int system;					/**< Satellite system of the PRNs (see nmeaSYSTEM), SYSTEM_UNKNOWN for GN sentences without a system ID */
 } nmeaGPGSA;
 
 /**
@@ -191,6 +209,9 @@ typedef struct _nmeaGPGSA {
  *           for up to 4 satellites per sentence
  *
  *      *75          the checksum data, always begins with *
+ *
+ * NMEA 4.10 adds the signal ID (a hexadecimal digit) after the satellites. A
+ * cycle of GSV sentences is sent per system (by talker) and signal.
  * </pre>
  */
 typedef struct _nmeaGPGSV {
@@ -199,8 +220,23 @@ typedef struct _nmeaGPGSV {
 	int pack_index;				/**< Message number */
 	int sat_count;				/**< Total number of satellites in view */
 	nmeaSATELLITE sat_data[NMEA_SATINPACK];
+	int system;					/**< Satellite system (see nmeaSYSTEM), SYSTEM_UNKNOWN for GN sentences */
+	int signal;					/**< Signal ID (NMEA 4.10), 0 when not reported */
 } nmeaGPGSV;
 
+/**
+ * The satellites of a cycle of GSV sentences (of a system and signal), that
+ * are assembled before they are merged into nmeaINFO at once
+ * @see nmea_GPGSV2cycle
+ */
+typedef struct _nmeaGSVCYCLE {
+	int system;					/**< Satellite system (see nmeaSYSTEM), SYSTEM_UNKNOWN for GN sentences */
+	int signal;					/**< Signal ID (NMEA 4.10), 0 when not reported */
+	int pack_count;				/**< Total number of messages in the cycle, 0 when no cycle is in progress */
+	uint32_t packs;				/**< Mask of the messages that were received (bit 0 for message 1) */
+	nmeaSATELLITE sat[NMEA_NSATPACKS * NMEA_SATINPACK];	/**< The satellites, by message (id 0 for unused entries) */
+} nmeaGSVCYCLE;
+
 /**
  * RMC -packet information structure (Recommended Minimum sentence C)
  *
@@ -233,13 +269,13 @@ typedef struct _nmeaGPRMC {
 	uint32_t present;			/**< Mask specifying which fields are present, same as in nmeaINFO */
 	nmeaTIME utc;				/**< UTC of position */
 	char status;				/**< Status (A = active or V = void) */
-	double lat;					/**< Latitude in NDEG - [degree][min].[sec/60] */
+	nmeaCOORD lat;				/**< Latitude in NDEG - [degree][min].[sec/60], in 1e-7 degrees with NMEA_FIXED_POINT */
 	char ns;					/**< [N]orth or [S]outh */
-	double lon;					/**< Longitude in NDEG - [degree][min].[sec/60] */
+	nmeaCOORD lon;				/**< Longitude in NDEG - [degree][min].[sec/60], in 1e-7 degrees with NMEA_FIXED_POINT */
 	char ew;					/**< [E]ast or [W]est */
-	double speed;				/**< Speed over the ground in knots */
-	double track;				/**< Track angle in degrees True */
-	double magvar;				/**< Magnetic variation degrees (Easterly var. subtracts from true course) */
+	nmeaSPEED speed;			/**< Speed over the ground in knots */
+	nmeaANGLE track;			/**< Track angle in degrees True */
+	nmeaANGLE magvar;			/**< Magnetic variation degrees (Easterly var. subtracts from true course) */
 	char magvar_ew;				/**< [E]ast or [W]est */
 	char mode;					/**< Mode indicator of fix type (A=autonomous, D=differential, E=Estimated, N=not valid, S=Simulator) */
 } nmeaGPRMC;
@@ -266,13 +302,13 @@ typedef struct _nmeaGPRMC {
  */
 typedef struct _nmeaGPVTG {
 	uint32_t present;			/**< Mask specifying which fields are present, same as in nmeaINFO */
-	double track;				/**< True track made good (degrees) */
+	nmeaANGLE track;			/**< True track made good (degrees) */
 	char track_t;				/**< Fixed text 'T' indicates that track made good is relative to true north */
-	double mtrack;				/**< Magnetic track made good */
+	nmeaANGLE mtrack;			/**< Magnetic track made good */
 	char mtrack_m;				/**< Fixed text 'M' */
-	double spn;					/**< Ground speed, knots */
+	nmeaSPEED spn;				/**< Ground speed, knots */
 	char spn_n;					/**< Fixed text 'N' indicates that speed over ground is in knots */
-	double spk;					/**< Ground speed, kilometers per hour */
+	nmeaSPEED spk;				/**< Ground speed, kilometers per hour */
 	char spk_k;					/**< Fixed text 'K' indicates that speed over ground is in kilometers/hour */
 } nmeaGPVTG;
 
@@ -0,0 +1,73 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NMEA_SNAPSHOT_H__
+#define __NMEA_SNAPSHOT_H__
+
+#include <nmea/info.h>
+#include <nmea/nmeaconf.h>
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * the number of 32-bit words of a published nmeaINFO structure (the structure
+ * holds 32-bit fields, so its size is a multiple of 4)
+ */
+#define NMEA_SNAPSHOT_WORDS (sizeof(nmeaINFO) / sizeof(uint32_t))
+
+_Static_assert((sizeof(nmeaINFO) % sizeof(uint32_t)) == 0, "nmeaINFO is not a whole number of 32-bit words");
+_Static_assert(sizeof(atomic_uint) == sizeof(uint32_t), "atomic_uint is not a 32-bit word");
+
+/**
+ * Publication of nmeaINFO structures from the parsing thread to any number of
+ * reading threads, without locks. The parsing thread merges sentences into its
+ * own nmeaINFO structure and publishes a copy of it (nmea_snapshot_publish),
+ * the readers take consistent copies of the last published structure
+ * (nmea_snapshot_read).
+ *
+ * The structure is published in two buffers that are each guarded by a
+ * sequence lock, the writer fills the buffer that is not the current one. The
+ * writer never waits, a reader only retries when the writer published twice
+ * while it was copying. The buffers are copied word by word with relaxed
+ * atomic loads and stores, which compile to plain loads and stores.
+ */
+typedef struct _nmeaSNAPSHOT {
+	atomic_uint version;							/**< The number of publications, the current buffer is version & 1 */
+
+	struct {
+		atomic_uint sequence;						/**< Twice the publication number of the buffer, minus 1 while it is written */
+		atomic_uint words[NMEA_SNAPSHOT_WORDS];		/**< The nmeaINFO structure */
+	} buffers[2];
+} nmeaSNAPSHOT;
+
+void nmea_snapshot_init(nmeaSNAPSHOT *snapshot);
+
+void nmea_snapshot_publish(nmeaSNAPSHOT *snapshot, const nmeaINFO *info);
+
+unsigned int nmea_snapshot_version(nmeaSNAPSHOT *snapshot);
+unsigned int nmea_snapshot_read(nmeaSNAPSHOT *snapshot, nmeaINFO *info);
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __NMEA_SNAPSHOT_H__ */
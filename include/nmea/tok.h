@@ -20,12 +20,15 @@
 
 #include <nmea/nmeaconf.h>
 
+#include <stdint.h>
+
 #ifdef  __cplusplus
 extern "C" {
 #endif /* __cplusplus */
 
 int nmea_atoi(const char *s, const int len, const int radix);
-double nmea_atof(const char *s, const int len);
+nmeaFLOAT nmea_atof(const char *s, const int len);
+int64_t nmea_atofixed(const char *s, const int len, const int32_t scale);
 int nmea_scanf(const char *s, int len, const char *format, ...);
 
 #ifdef  __cplusplus
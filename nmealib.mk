@@ -1,8 +1,14 @@
 NMEAINC = 	$(NMEALIB)/include
 
 NMEASRC = 	$(NMEALIB)/src/conversions.c \
+		$(NMEALIB)/src/epoch.c \
+		$(NMEALIB)/src/error.c \
 		$(NMEALIB)/src/gmath.c \
 		$(NMEALIB)/src/info.c \
 		$(NMEALIB)/src/parse.c \
 		$(NMEALIB)/src/parser.c \
+		$(NMEALIB)/src/platform.c \
+		$(NMEALIB)/src/ring.c \
+		$(NMEALIB)/src/scan.c \
+		$(NMEALIB)/src/snapshot.c \
 		$(NMEALIB)/src/tok.c
\ No newline at end of file
@@ -22,6 +22,37 @@
 #include <string.h>
 #include <math.h>
 
+/**
+ * Store a field of a nmeaINFO structure, flagging it as changed when its value
+ * changes
+ */
+#define NMEA_INFO_UPDATE(info, field, value, fieldName) \
+	do { \
+		if ((info)->field != (value)) { \
+			(info)->field = (value); \
+			(info)->changed |= (fieldName); \
+		} \
+	} while (0)
+
+/**
+ * Merge the presence of the fields of a packet into a nmeaINFO structure,
+ * flagging the fields that become present as changed
+ *
+ * @param info a pointer to the nmeaINFO structure
+ * @param present the presence field of the packet
+ * @param type the packet type, for the smask
+ */
+static inline void nmea_info_merge_present(nmeaINFO *info, const uint32_t present, const enum nmeaPACKTYPE type) {
+	uint32_t merged = present | SMASK;
+
+	info->changed |= merged & ~info->present;
+	info->present |= merged;
+	if (!(info->smask & (int) type)) {
+		info->smask |= type;
+		info->changed |= SMASK;
+	}
+}
+
 /**
  * Determine the number of GSV sentences needed for a number of sats
  *
@@ -40,6 +71,7 @@ int nmea_gsv_npack(int sats) {
 	return pack_count;
 }
 
+#if NMEA_SENTENCE_GGA
 /**
  * Fill nmeaINFO structure from GGA packet structure
  *
@@ -50,37 +82,37 @@ void nmea_GPGGA2info(const nmeaGPGGA *pack, nmeaINFO *info) {
 	NMEA_ASSERT(pack);
 	NMEA_ASSERT(info);
 
-	info->present |= pack->present;
-	nmea_INFO_set_present(&info->present, SMASK);
-	info->smask |= GPGGA;
+	nmea_info_merge_present(info, pack->present, GPGGA);
 	if (nmea_INFO_is_present(pack->present, UTCTIME)) {
-		info->utc.hour = pack->utc.hour;
-		info->utc.min = pack->utc.min;
-		info->utc.sec = pack->utc.sec;
-		info->utc.hsec = pack->utc.hsec;
+		NMEA_INFO_UPDATE(info, utc.hour, pack->utc.hour, UTCTIME);
+		NMEA_INFO_UPDATE(info, utc.min, pack->utc.min, UTCTIME);
+		NMEA_INFO_UPDATE(info, utc.sec, pack->utc.sec, UTCTIME);
+		NMEA_INFO_UPDATE(info, utc.hsec, pack->utc.hsec, UTCTIME);
 	}
 	if (nmea_INFO_is_present(pack->present, LAT)) {
-		info->lat = ((pack->ns == 'N') ? pack->lat : -pack->lat);
+		NMEA_INFO_UPDATE(info, lat, ((pack->ns == 'N') ? pack->lat : -pack->lat), LAT);
 	}
 	if (nmea_INFO_is_present(pack->present, LON)) {
-		info->lon = ((pack->ew == 'E') ? pack->lon : -pack->lon);
+		NMEA_INFO_UPDATE(info, lon, ((pack->ew == 'E') ? pack->lon : -pack->lon), LON);
 	}
 	if (nmea_INFO_is_present(pack->present, SIG)) {
-		info->sig = pack->sig;
+		NMEA_INFO_UPDATE(info, sig, pack->sig, SIG);
 	}
 	if (nmea_INFO_is_present(pack->present, SATINUSECOUNT)) {
-		info->satinfo.inuse = pack->satinuse;
+		NMEA_INFO_UPDATE(info, satinfo.inuse, pack->satinuse, SATINUSECOUNT);
 	}
 	if (nmea_INFO_is_present(pack->present, HDOP)) {
-		info->HDOP = pack->HDOP;
+		NMEA_INFO_UPDATE(info, HDOP, pack->HDOP, HDOP);
 	}
 	if (nmea_INFO_is_present(pack->present, ELV)) {
-		info->elv = pack->elv;
+		NMEA_INFO_UPDATE(info, elv, pack->elv, ELV);
 	}
 	/* ignore diff and diff_units */
 	/* ignore dgps_age and dgps_sid */
 }
+#endif
 
+#if NMEA_SENTENCE_GSA
 /**
  * Fill nmeaINFO structure from GSA packet structure
  *
@@ -88,83 +120,245 @@ void nmea_GPGGA2info(const nmeaGPGGA *pack, nmeaINFO *info) {
  * @param info a pointer to the nmeaINFO structure
  */
 void nmea_GPGSA2info(const nmeaGPGSA *pack, nmeaINFO *info) {
-	int i = 0;
-
 	NMEA_ASSERT(pack);
 	NMEA_ASSERT(info);
 
-	info->present |= pack->present;
-	nmea_INFO_set_present(&info->present, SMASK);
-	info->smask |= GPGSA;
+	nmea_info_merge_present(info, pack->present, GPGSA);
 	if (nmea_INFO_is_present(pack->present, FIX)) {
 		/* fix_mode is ignored */
-		info->fix = pack->fix_type;
+		NMEA_INFO_UPDATE(info, fix, pack->fix_type, FIX);
 	}
 	if (nmea_INFO_is_present(pack->present, SATINUSE)) {
-		info->satinfo.inuse = 0;
-		for (i = 0; i < NMEA_MAXSAT; i++) {
-			info->satinfo.in_use[i] = pack->sat_prn[i];
-			if (pack->sat_prn[i]) {
-				info->satinfo.inuse++;
-			}
+		int inuse = info->satinfo.inuse;
+
+		/* only replaces the satellites in use of the system(s) of the sentence */
+		if (nmea_INFO_sat_use(&info->satinfo, pack->system, pack->sat_prn, NMEA_SATINGSA)) {
+			info->changed |= SATINUSE;
+		}
+		if ((info->satinfo.inuse != inuse) || !nmea_INFO_is_present(info->present, SATINUSECOUNT)) {
+			info->changed |= SATINUSECOUNT;
 		}
 		nmea_INFO_set_present(&info->present, SATINUSECOUNT);
 	}
 	if (nmea_INFO_is_present(pack->present, PDOP)) {
-		info->PDOP = pack->PDOP;
+		NMEA_INFO_UPDATE(info, PDOP, pack->PDOP, PDOP);
 	}
 	if (nmea_INFO_is_present(pack->present, HDOP)) {
-		info->HDOP = pack->HDOP;
+		NMEA_INFO_UPDATE(info, HDOP, pack->HDOP, HDOP);
 	}
 	if (nmea_INFO_is_present(pack->present, VDOP)) {
-		info->VDOP = pack->VDOP;
+		NMEA_INFO_UPDATE(info, VDOP, pack->VDOP, VDOP);
 	}
 }
+#endif
 
+#if NMEA_SENTENCE_GSV
 /**
- * Fill nmeaINFO structure from GSV packet structure
+ * Mark the satellites in view of the system and signal of GSV sentences as
+ * stale (see nmea_INFO_sat_mark)
+ *
+ * @param info a pointer to the nmeaINFO structure
+ * @param system the satellite system of the sentences
+ * @param signal the signal ID of the sentences
+ */
+static void nmea_gsv_mark(nmeaINFO *info, const int system, const int signal) {
+	if (system != SYSTEM_UNKNOWN) {
+		nmea_INFO_sat_mark(&info->satinfo, system, signal);
+	} else {
+		/* the satellites of GN sentences are GPS or GLONASS (see nmea_INFO_sat_system) */
+		nmea_INFO_sat_mark(&info->satinfo, SYSTEM_GPS, signal);
+		nmea_INFO_sat_mark(&info->satinfo, SYSTEM_GLONASS, signal);
+	}
+}
+
+/**
+ * Remove the stale satellites in view of the system and signal of GSV
+ * sentences (see nmea_INFO_sat_sweep)
+ *
+ * @param info a pointer to the nmeaINFO structure
+ * @param system the satellite system of the sentences
+ * @param signal the signal ID of the sentences
+ */
+static void nmea_gsv_sweep(nmeaINFO *info, const int system, const int signal) {
+	if (system != SYSTEM_UNKNOWN) {
+		nmea_INFO_sat_sweep(&info->satinfo, system, signal);
+	} else {
+		nmea_INFO_sat_sweep(&info->satinfo, SYSTEM_GPS, signal);
+		nmea_INFO_sat_sweep(&info->satinfo, SYSTEM_GLONASS, signal);
+	}
+}
+
+/**
+ * Update the satellites in view with the satellites of GSV sentences
+ *
+ * @param info a pointer to the nmeaINFO structure
+ * @param sat the satellites (id 0 for unused entries)
+ * @param count the number of entries in sat
+ */
+static void nmea_gsv_update(nmeaINFO *info, const nmeaSATELLITE *sat, const int count) {
+	int sat_index;
+
+	for (sat_index = 0; sat_index < count; sat_index++) {
+		if (sat[sat_index].id) {
+			nmea_INFO_sat_update(&info->satinfo, &sat[sat_index]);
+		}
+	}
+}
+
+/**
+ * Flag the satellites in view as changed when the satellite store flagged
+ * entries that changed
+ *
+ * @param info a pointer to the nmeaINFO structure
+ */
+static void nmea_gsv_changed(nmeaINFO *info) {
+	int word;
+
+	for (word = 0; word < NMEA_SATWORDS; word++) {
+		if (info->satinfo.changed[word]) {
+			info->changed |= SATINVIEW;
+			break;
+		}
+	}
+}
+
+/**
+ * Fill nmeaINFO structure from GSV packet structure.
+ *
+ * Every sentence updates (or adds) its satellites. The satellites in view of
+ * the system and signal of the sentences that were not reported in a cycle are
+ * removed by its last sentence (see nmea_INFO_sat_mark). The satellites of the
+ * other systems and signals are kept. Readers see a mix of the old and the new
+ * satellites while a cycle is in progress, nmea_GPGSV2cycle avoids that.
  *
  * @param pack a pointer to the packet structure
  * @param info a pointer to the nmeaINFO structure
  */
 void nmea_GPGSV2info(const nmeaGPGSV *pack, nmeaINFO *info) {
-	int pack_index;
+	NMEA_ASSERT(pack);
+	NMEA_ASSERT(info);
+
+	nmea_info_merge_present(info, pack->present, GPGSV);
+
+	if (pack->pack_index == 1) {
+		nmea_gsv_mark(info, pack->system, pack->signal);
+	}
+
+	nmea_gsv_update(info, pack->sat_data, (nmea_INFO_is_present(pack->present, SATINVIEW) ? NMEA_SATINPACK : 0));
+
+	if (pack->pack_index == pack->pack_count) {
+		nmea_gsv_sweep(info, pack->system, pack->signal);
+	}
+
+	nmea_gsv_changed(info);
+}
+
+/**
+ * Assemble a GSV sentence into a cycle, and fill the nmeaINFO structure from
+ * the cycle once it is complete. The sentences of a cycle may arrive in any
+ * order. A sentence of another cycle (another system, signal or number of
+ * messages, or a repeated first message) abandons the cycle in progress, which
+ * is then handled as configured by NMEA_GSV_PARTIAL.
+ *
+ * @param pack a pointer to the packet structure
+ * @param cycle a pointer to the cycle
+ * @param info a pointer to the nmeaINFO structure
+ * @return 1 (true) when satellites were merged into the nmeaINFO structure, 0 (false) otherwise
+ */
+int nmea_GPGSV2cycle(const nmeaGPGSV *pack, nmeaGSVCYCLE *cycle, nmeaINFO *info) {
+	int merged = 0;
+	uint32_t pack_bit;
 
 	NMEA_ASSERT(pack);
+	NMEA_ASSERT(cycle);
 	NMEA_ASSERT(info);
 
-	pack_index = pack->pack_index;
-	if (pack_index < 1)
-		pack_index = 1;
+	if ((pack->pack_index < 1) || (pack->pack_index > pack->pack_count) || (pack->pack_count > NMEA_NSATPACKS)) {
+		return 0;
+	}
 
-	if (pack_index > pack->pack_count)
-		pack_index = pack->pack_count;
+	pack_bit = 1u << (pack->pack_index - 1);
+	if (cycle->pack_count
+			&& ((pack->system != cycle->system) || (pack->signal != cycle->signal)
+					|| (pack->pack_count != cycle->pack_count) || ((pack->pack_index == 1) && (cycle->packs & pack_bit)))) {
+		merged = NMEA_GSV_PARTIAL;
+		nmea_GSVcycle2info(cycle, info);
+	}
 
-	if ((pack_index * NMEA_SATINPACK) > NMEA_MAXSAT)
-		pack_index = NMEA_NSATPACKS;
+	if (!cycle->pack_count) {
+		cycle->system = pack->system;
+		cycle->signal = pack->signal;
+		cycle->pack_count = pack->pack_count;
+		cycle->packs = 0;
+	}
 
-	info->present |= pack->present;
-	nmea_INFO_set_present(&info->present, SMASK);
-	info->smask |= GPGSV;
+	/* a sentence without satellites in view still counts for the cycle */
 	if (nmea_INFO_is_present(pack->present, SATINVIEW)) {
-		int sat_index;
-
-		/* index of 1st sat in pack */
-		int sat_offset = (pack_index - 1) * NMEA_SATINPACK;
-		/* the number of sats in this sentence */
-		int sat_count = ((sat_offset + NMEA_SATINPACK) > pack->sat_count) ? (pack->sat_count - sat_offset) : NMEA_SATINPACK;
-
-		for (sat_index = 0; sat_index < sat_count; sat_index++) {
-			info->satinfo.sat[sat_offset + sat_index].id = pack->sat_data[sat_index].id;
-			info->satinfo.sat[sat_offset + sat_index].elv = pack->sat_data[sat_index].elv;
-			info->satinfo.sat[sat_offset + sat_index].azimuth = pack->sat_data[sat_index].azimuth;
-			info->satinfo.sat[sat_offset + sat_index].sig = pack->sat_data[sat_index].sig;
+		memcpy(&cycle->sat[(pack->pack_index - 1) * NMEA_SATINPACK], pack->sat_data, sizeof(pack->sat_data));
+	} else {
+		memset(&cycle->sat[(pack->pack_index - 1) * NMEA_SATINPACK], 0, sizeof(pack->sat_data));
+	}
+	cycle->packs |= pack_bit;
+
+	if (cycle->packs == ((1u << cycle->pack_count) - 1)) {
+		merged = 1;
+		nmea_GSVcycle2info(cycle, info);
+	}
+
+	return merged;
+}
+
+/**
+ * Fill nmeaINFO structure from a GSV cycle, at once, and end the cycle. A
+ * complete cycle replaces the satellites in view of its system and signal. An
+ * incomplete cycle only updates them, or is dropped (see NMEA_GSV_PARTIAL).
+ *
+ * @param cycle a pointer to the cycle
+ * @param info a pointer to the nmeaINFO structure
+ */
+void nmea_GSVcycle2info(nmeaGSVCYCLE *cycle, nmeaINFO *info) {
+	bool complete;
+	int pack_index;
+
+	NMEA_ASSERT(cycle);
+	NMEA_ASSERT(info);
+
+	if (!cycle->pack_count) {
+		return;
+	}
+
+	complete = (cycle->packs == ((1u << cycle->pack_count) - 1));
+	if (complete || NMEA_GSV_PARTIAL) {
+		nmea_info_merge_present(info, 0, GPGSV);
+
+		if (complete) {
+			nmea_gsv_mark(info, cycle->system, cycle->signal);
 		}
 
-		info->satinfo.inview = pack->sat_count;
+		for (pack_index = 0; pack_index < cycle->pack_count; pack_index++) {
+			if (cycle->packs & (1u << pack_index)) {
+				nmea_gsv_update(info, &cycle->sat[pack_index * NMEA_SATINPACK], NMEA_SATINPACK);
+			}
+		}
+
+		if (complete) {
+			nmea_gsv_sweep(info, cycle->system, cycle->signal);
+		}
+
+		nmea_gsv_changed(info);
+
+		if (info->satinfo.inview && !nmea_INFO_is_present(info->present, SATINVIEW)) {
+			nmea_INFO_set_present(&info->present, SATINVIEW);
+			info->changed |= SATINVIEW;
+		}
 	}
+
+	cycle->pack_count = 0;
+	cycle->packs = 0;
 }
+#endif
 
+#if NMEA_SENTENCE_RMC
 /**
  * Fill nmeaINFO structure from RMC packet structure
  *
@@ -175,51 +369,57 @@ void nmea_GPRMC2info(const nmeaGPRMC *pack, nmeaINFO *info) {
 	NMEA_ASSERT(pack);
 	NMEA_ASSERT(info);
 
-	info->present |= pack->present;
-	nmea_INFO_set_present(&info->present, SMASK);
-	info->smask |= GPRMC;
+	nmea_info_merge_present(info, pack->present, GPRMC);
 	if (nmea_INFO_is_present(pack->present, UTCDATE)) {
-		info->utc.year = pack->utc.year;
-		info->utc.mon = pack->utc.mon;
-		info->utc.day = pack->utc.day;
+		NMEA_INFO_UPDATE(info, utc.year, pack->utc.year, UTCDATE);
+		NMEA_INFO_UPDATE(info, utc.mon, pack->utc.mon, UTCDATE);
+		NMEA_INFO_UPDATE(info, utc.day, pack->utc.day, UTCDATE);
 	}
 	if (nmea_INFO_is_present(pack->present, UTCTIME)) {
-		info->utc.hour = pack->utc.hour;
-		info->utc.min = pack->utc.min;
-		info->utc.sec = pack->utc.sec;
-		info->utc.hsec = pack->utc.hsec;
-	}
-	nmea_INFO_set_present(&info->present, SIG);
-	nmea_INFO_set_present(&info->present, FIX);
-	if (pack->status == 'A') {
-		if (info->sig == NMEA_SIG_BAD) {
-			info->sig = NMEA_SIG_MID;
-		}
-		if (info->fix == NMEA_FIX_BAD) {
-			info->fix = NMEA_FIX_2D;
+		NMEA_INFO_UPDATE(info, utc.hour, pack->utc.hour, UTCTIME);
+		NMEA_INFO_UPDATE(info, utc.min, pack->utc.min, UTCTIME);
+		NMEA_INFO_UPDATE(info, utc.sec, pack->utc.sec, UTCTIME);
+		NMEA_INFO_UPDATE(info, utc.hsec, pack->utc.hsec, UTCTIME);
+	}
+	/* sig and fix follow from the status */
+	if (nmea_INFO_is_present(pack->present, SIG)) {
+		if (pack->status == 'A') {
+			if (info->sig == NMEA_SIG_BAD) {
+				NMEA_INFO_UPDATE(info, sig, NMEA_SIG_MID, SIG);
+			}
+			if (info->fix == NMEA_FIX_BAD) {
+				NMEA_INFO_UPDATE(info, fix, NMEA_FIX_2D, FIX);
+			}
+		} else {
+			NMEA_INFO_UPDATE(info, sig, NMEA_SIG_BAD, SIG);
+			NMEA_INFO_UPDATE(info, fix, NMEA_FIX_BAD, FIX);
 		}
-	} else {
-		info->sig = NMEA_SIG_BAD;
-		info->fix = NMEA_FIX_BAD;
 	}
 	if (nmea_INFO_is_present(pack->present, LAT)) {
-		info->lat = ((pack->ns == 'N') ? pack->lat : -pack->lat);
+		NMEA_INFO_UPDATE(info, lat, ((pack->ns == 'N') ? pack->lat : -pack->lat), LAT);
 	}
 	if (nmea_INFO_is_present(pack->present, LON)) {
-		info->lon = ((pack->ew == 'E') ? pack->lon : -pack->lon);
+		NMEA_INFO_UPDATE(info, lon, ((pack->ew == 'E') ? pack->lon : -pack->lon), LON);
 	}
 	if (nmea_INFO_is_present(pack->present, SPEED)) {
-		info->speed = pack->speed * NMEA_TUD_KNOTS;
+#if NMEA_FIXED_POINT
+		/* already converted from knots while parsing */
+		NMEA_INFO_UPDATE(info, speed, pack->speed, SPEED);
+#else
+		NMEA_INFO_UPDATE(info, speed, pack->speed * NMEA_TUD_KNOTS, SPEED);
+#endif
 	}
 	if (nmea_INFO_is_present(pack->present, TRACK)) {
-		info->track = pack->track;
+		NMEA_INFO_UPDATE(info, track, pack->track, TRACK);
 	}
 	if (nmea_INFO_is_present(pack->present, MAGVAR)) {
-		info->magvar = ((pack->magvar_ew == 'E') ? pack->magvar : -pack->magvar);
+		NMEA_INFO_UPDATE(info, magvar, ((pack->magvar_ew == 'E') ? pack->magvar : -pack->magvar), MAGVAR);
 	}
 	/* mode is ignored */
 }
+#endif
 
+#if NMEA_SENTENCE_VTG
 /**
  * Fill nmeaINFO structure from VTG packet structure
  *
@@ -230,16 +430,15 @@ void nmea_GPVTG2info(const nmeaGPVTG *pack, nmeaINFO *info) {
 	NMEA_ASSERT(pack);
 	NMEA_ASSERT(info);
 
-	info->present |= pack->present;
-	nmea_INFO_set_present(&info->present, SMASK);
-	info->smask |= GPVTG;
+	nmea_info_merge_present(info, pack->present, GPVTG);
 	if (nmea_INFO_is_present(pack->present, SPEED)) {
-		info->speed = pack->spk;
+		NMEA_INFO_UPDATE(info, speed, pack->spk, SPEED);
 	}
 	if (nmea_INFO_is_present(pack->present, TRACK)) {
-		info->track = pack->track;
+		NMEA_INFO_UPDATE(info, track, pack->track, TRACK);
 	}
 	if (nmea_INFO_is_present(pack->present, MTRACK)) {
-		info->mtrack = pack->mtrack;
+		NMEA_INFO_UPDATE(info, mtrack, pack->mtrack, MTRACK);
 	}
 }
+#endif
@@ -0,0 +1,217 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <nmea/epoch.h>
+
+#include <string.h>
+
+/**
+ * Get the UTC time of a sentence
+ *
+ * @param type the sentence type
+ * @param pack a pointer to the decoded sentence
+ * @return a pointer to the time, NULL when the sentence has no time
+ */
+static const nmeaTIME * nmea_epoch_sentence_time(const enum nmeaPACKTYPE type, const void *pack) {
+#if !(NMEA_SENTENCE_GGA || NMEA_SENTENCE_RMC)
+  /* only GGA and RMC sentences have a time */
+  (void) pack;
+#endif
+
+  switch (type) {
+#if NMEA_SENTENCE_GGA
+    case GPGGA:
+      if (nmea_INFO_is_present(((const nmeaGPGGA *) pack)->present, UTCTIME)) {
+        return &((const nmeaGPGGA *) pack)->utc;
+      }
+      break;
+#endif
+
+#if NMEA_SENTENCE_RMC
+    case GPRMC:
+      if (nmea_INFO_is_present(((const nmeaGPRMC *) pack)->present, UTCTIME)) {
+        return &((const nmeaGPRMC *) pack)->utc;
+      }
+      break;
+#endif
+
+    default:
+      break;
+  }
+
+  return NULL;
+}
+
+/**
+ * Determine if two UTC times are the same time of day
+ *
+ * @param a a pointer to the first time
+ * @param b a pointer to the second time
+ * @return true when the times are the same
+ */
+static inline bool nmea_epoch_same_time(const nmeaTIME *a, const nmeaTIME *b) {
+  return ((a->hour == b->hour) && (a->min == b->min) && (a->sec == b->sec) && (a->hsec == b->hsec));
+}
+
+/**
+ * Determine whether a GSV cycle is in progress
+ *
+ * @param epoch a pointer to the assembler
+ * @return true when GSV messages of a cycle are missing
+ */
+static inline bool nmea_epoch_gsv_pending(const nmeaEPOCH *epoch) {
+#if NMEA_SENTENCE_GSV
+  return epoch->merge.gsv_cycle.pack_count != 0;
+#else
+  (void) epoch;
+  return false;
+#endif
+}
+
+/**
+ * The parser callback of the assembler, for all sentence types
+ *
+ * @param type the sentence type
+ * @param pack a pointer to the decoded sentence
+ * @param s the raw sentence
+ * @param len the length of the raw sentence
+ * @param arg a pointer to the assembler
+ */
+static void nmea_epoch_sentence(const enum nmeaPACKTYPE type, const void *pack, const char *s, const int len,
+    void *arg) {
+  nmeaEPOCH *epoch = (nmeaEPOCH *) arg;
+  const nmeaTIME *utc = nmea_epoch_sentence_time(type, pack);
+
+  NMEA_ASSERT(epoch);
+
+  /* a sentence of the next cycle closes the epoch before it is merged */
+  if ((epoch->close & EPOCH_CLOSE_TIME) && utc && epoch->has_time && !nmea_epoch_same_time(utc, &epoch->utc)) {
+    nmea_epoch_close(epoch);
+  }
+
+  nmea_parser_info_callback(type, pack, s, len, &epoch->merge);
+
+  epoch->received |= type;
+  epoch->last = epoch->now;
+  if (utc && !epoch->has_time) {
+    epoch->utc = *utc;
+    epoch->has_time = true;
+  }
+
+  if ((epoch->close & EPOCH_CLOSE_COMPLETE) && ((epoch->received & epoch->expected) == epoch->expected)
+      && !nmea_epoch_gsv_pending(epoch)) {
+    nmea_epoch_close(epoch);
+  }
+}
+
+/**
+ * Initialise the epoch assembler
+ *
+ * @param epoch a pointer to the assembler
+ * @param close the rules that close an epoch (see nmeaEPOCH_CLOSE)
+ * @param expected the sentence types (see nmeaPACKTYPE) that complete an epoch, for EPOCH_CLOSE_COMPLETE
+ * @param timeout the time without sentences that closes an epoch, for EPOCH_CLOSE_TIMEOUT, in the unit of the
+ * times that are given to nmea_epoch_parse and nmea_epoch_poll
+ * @param callback the epoch callback
+ * @param arg the argument for the epoch callback
+ */
+void nmea_epoch_init(nmeaEPOCH *epoch, const uint32_t close, const int expected, const uint32_t timeout,
+    nmeaEPOCHCALLBACK callback, void *arg) {
+  int type;
+
+  NMEA_ASSERT(epoch);
+
+  memset(epoch, 0, sizeof(*epoch));
+  nmea_zero_INFO(&epoch->info);
+  nmea_parser_info_merge_init(&epoch->merge, &epoch->info);
+  nmea_parser_init(&epoch->parser);
+  for (type = GPGGA; type <= GPVTG; type <<= 1) {
+    nmea_parser_set_callback(&epoch->parser, (enum nmeaPACKTYPE) type, nmea_epoch_sentence, epoch);
+  }
+
+  epoch->close = close;
+  epoch->expected = expected;
+  epoch->timeout = timeout;
+  epoch->callback = callback;
+  epoch->arg = arg;
+}
+
+/**
+ * Parse a string and assemble the sentences into epochs, calling the epoch
+ * callback for every epoch that closes
+ *
+ * @param epoch a pointer to the assembler
+ * @param s the string
+ * @param len the length of the string
+ * @param now the current time, for EPOCH_CLOSE_TIMEOUT
+ * @return the number of packets that were parsed
+ */
+int nmea_epoch_parse(nmeaEPOCH *epoch, const char *s, const int len, const uint32_t now) {
+  NMEA_ASSERT(epoch);
+
+  /* a sentence after the timeout belongs to a new epoch */
+  nmea_epoch_poll(epoch, now);
+
+  epoch->now = now;
+  return nmea_parse(&epoch->parser, s, len, NULL);
+}
+
+/**
+ * Close the epoch when no sentence was received for the timeout. Call it
+ * periodically when EPOCH_CLOSE_TIMEOUT is used, so that the last epoch of a
+ * burst is published without waiting for the next burst.
+ *
+ * @param epoch a pointer to the assembler
+ * @param now the current time
+ * @return true when the epoch was closed
+ */
+bool nmea_epoch_poll(nmeaEPOCH *epoch, const uint32_t now) {
+  NMEA_ASSERT(epoch);
+
+  if ((epoch->close & EPOCH_CLOSE_TIMEOUT) && epoch->received && ((uint32_t) (now - epoch->last) >= epoch->timeout)) {
+    return nmea_epoch_close(epoch);
+  }
+
+  return false;
+}
+
+/**
+ * Close the epoch: publish its information through the epoch callback and
+ * start a new epoch. The information is kept, the next epoch updates it.
+ *
+ * @param epoch a pointer to the assembler
+ * @return true when the epoch was published, false when it was empty
+ */
+bool nmea_epoch_close(nmeaEPOCH *epoch) {
+  NMEA_ASSERT(epoch);
+
+  if (!epoch->received) {
+    return false;
+  }
+
+  if (epoch->callback) {
+    epoch->callback(&epoch->info, epoch->arg);
+  }
+  epoch->epochs++;
+
+  nmea_INFO_clear_changed(&epoch->info);
+  epoch->received = 0;
+  epoch->has_time = false;
+
+  return true;
+}
@@ -0,0 +1,224 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmea/error.h>
+
+#include <nmea/sentence.h>
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+#define NMEA_ERROR_RING_MASK (NMEA_ERROR_RING_SIZE - 1u)
+
+/*
+ * The error records, a bounded lock-free queue for any number of recording
+ * threads (and interrupt handlers) and one consumer. Every slot has a sequence
+ * that tells whether it is free or filled for a position. The sequences are
+ * stored minus the index of their slot, so that the zero-initialised queue is
+ * empty and ready for use.
+ */
+static struct {
+  atomic_uint head;           /**< The next position to fill */
+  atomic_uint tail;           /**< The next position to consume */
+  atomic_uint dropped;        /**< The number of records that did not fit */
+  struct {
+    atomic_uint sequence;     /**< The position that the slot is ready for, minus its index */
+    nmeaERROR error;          /**< The record */
+  } slots[NMEA_ERROR_RING_SIZE];
+} errors;
+
+/**
+ * Record a decode error, never blocks: the record is dropped and counted when
+ * the queue is full. Cheap enough for the decoding path, the records are
+ * formatted later (see nmea_error_flush).
+ *
+ * @param code the error
+ * @param type the sentence type (see nmeaPACKTYPE)
+ * @param field the index of the offending field
+ * @param value the offending value
+ */
+void nmea_error_record(const enum nmeaERRORCODE code, const int type, const int field, const int32_t value) {
+  unsigned int position = atomic_load_explicit(&errors.head, memory_order_relaxed);
+
+  for (;;) {
+    unsigned int index = position & NMEA_ERROR_RING_MASK;
+    int lag = (int) ((atomic_load_explicit(&errors.slots[index].sequence, memory_order_acquire) + index) - position);
+
+    if (lag < 0) {
+      /* the slot still holds the record of the previous lap */
+      atomic_fetch_add_explicit(&errors.dropped, 1, memory_order_relaxed);
+      return;
+    }
+
+    if (!lag) {
+      if (atomic_compare_exchange_weak_explicit(&errors.head, &position, position + 1, memory_order_relaxed,
+          memory_order_relaxed)) {
+        errors.slots[index].error.code = (uint8_t) code;
+        errors.slots[index].error.type = (uint8_t) type;
+        errors.slots[index].error.field = (uint8_t) field;
+        errors.slots[index].error.reserved = 0;
+        errors.slots[index].error.value = value;
+        atomic_store_explicit(&errors.slots[index].sequence, (position + 1) - index, memory_order_release);
+        return;
+      }
+    } else {
+      /* another thread took the slot */
+      position = atomic_load_explicit(&errors.head, memory_order_relaxed);
+    }
+  }
+}
+
+/**
+ * Take the oldest error record (one consumer only)
+ *
+ * @param error a pointer to the record (output)
+ * @return true when a record was taken, false when there are none
+ */
+bool nmea_error_pop(nmeaERROR *error) {
+  unsigned int position = atomic_load_explicit(&errors.tail, memory_order_relaxed);
+  unsigned int index = position & NMEA_ERROR_RING_MASK;
+
+  NMEA_ASSERT(error);
+
+  if ((atomic_load_explicit(&errors.slots[index].sequence, memory_order_acquire) + index) != (position + 1)) {
+    return false;
+  }
+
+  *error = errors.slots[index].error;
+  atomic_store_explicit(&errors.slots[index].sequence, (position + NMEA_ERROR_RING_SIZE) - index, memory_order_release);
+  atomic_store_explicit(&errors.tail, position + 1, memory_order_relaxed);
+  return true;
+}
+
+/**
+ * @return the number of error records that were dropped because the queue was full
+ */
+uint32_t nmea_error_dropped(void) {
+  return atomic_load_explicit(&errors.dropped, memory_order_relaxed);
+}
+
+/**
+ * Get the description of an error
+ *
+ * @param code the error
+ * @return the description
+ */
+const char * nmea_error_string(const enum nmeaERRORCODE code) {
+  switch (code) {
+    case PARSE_ERROR_TOKENS:
+      return "too few or malformed fields";
+    case PARSE_ERROR_TIME_FORMAT:
+      return "invalid time format";
+    case PARSE_ERROR_DATE_FORMAT:
+      return "invalid date format";
+    case PARSE_ERROR_TIME:
+      return "invalid time";
+    case PARSE_ERROR_DATE:
+      return "invalid date";
+    case PARSE_ERROR_DIRECTION:
+      return "invalid direction";
+    case PARSE_ERROR_MODE:
+      return "invalid mode";
+    case PARSE_ERROR_STATUS:
+      return "invalid status";
+    case PARSE_ERROR_UNIT:
+      return "invalid unit";
+    case PARSE_ERROR_SIGNAL:
+      return "invalid signal";
+    case PARSE_ERROR_SYSTEM:
+      return "invalid system ID";
+    case PARSE_ERROR_FIX_MODE:
+      return "invalid fix mode";
+    case PARSE_ERROR_FIX_TYPE:
+      return "invalid fix type";
+    case PARSE_ERROR_PACK:
+      return "inconsistent pack";
+    case PARSE_ERROR_SAT_ID:
+      return "invalid satellite ID";
+    case PARSE_ERROR_SAT_ELEVATION:
+      return "invalid satellite elevation";
+    case PARSE_ERROR_SAT_AZIMUTH:
+      return "invalid satellite azimuth";
+    case PARSE_ERROR_SAT_SNR:
+      return "invalid satellite signal";
+    case PARSE_ERROR_NONE:
+    case PARSE_ERROR_LAST:
+    default:
+      return "unknown error";
+  }
+}
+
+/**
+ * Get the name of a sentence type
+ *
+ * @param type the sentence type
+ * @return the name
+ */
+static const char * nmea_error_type(const int type) {
+  switch (type) {
+    case GPGGA:
+      return "GGA";
+    case GPGSA:
+      return "GSA";
+    case GPGSV:
+      return "GSV";
+    case GPRMC:
+      return "RMC";
+    case GPVTG:
+      return "VTG";
+    default:
+      return "NMEA";
+  }
+}
+
+/**
+ * Format an error record
+ *
+ * @param error a pointer to the record
+ * @param buf the buffer
+ * @param size the size of the buffer
+ * @return the length of the text (see snprintf)
+ */
+int nmea_error_format(const nmeaERROR *error, char *buf, const size_t size) {
+  NMEA_ASSERT(error);
+  NMEA_ASSERT(buf);
+
+  return snprintf(buf, size, "%s parse error: %s in field %d (%ld)\r\n", nmea_error_type(error->type),
+      nmea_error_string((enum nmeaERRORCODE) error->code), error->field, (long) error->value);
+}
+
+/**
+ * Write the error records to the error sink of the platform (see nmea_error)
+ * and remove them. Call from a low priority thread, this is where the slow
+ * formatting and writing happen.
+ *
+ * @return the number of records that were written
+ */
+int nmea_error_flush(void) {
+  nmeaERROR error;
+  int count = 0;
+
+  while (nmea_error_pop(&error)) {
+    char buf[NMEA_DEF_PARSEBUFF];
+
+    nmea_error_format(&error, buf, sizeof(buf));
+    nmea_error("%s", buf);
+    count++;
+  }
+
+  return count;
+}
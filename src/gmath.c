@@ -19,13 +19,47 @@
 
 #include <math.h>
 
+#if NMEA_SINGLE_PRECISION
+#define NMEA_SIN(x)         sinf(x)
+#define NMEA_COS(x)         cosf(x)
+#define NMEA_TAN(x)         tanf(x)
+#define NMEA_ASIN(x)        asinf(x)
+#define NMEA_ACOS(x)        acosf(x)
+#define NMEA_ATAN(x)        atanf(x)
+#define NMEA_ATAN2(y, x)    atan2f(y, x)
+#define NMEA_SQRT(x)        sqrtf(x)
+#define NMEA_POW(x, y)      powf(x, y)
+#define NMEA_MODF(x, i)     modff(x, i)
+#define NMEA_FABS(x)        fabsf(x)
+#define NMEA_LROUND(x)      lroundf(x)
+
+/** the convergence limit of the iterations (a few ulp of a float radian) */
+#define NMEA_GMATH_EPSILON  (1e-6f)
+#else
+#define NMEA_SIN(x)         sin(x)
+#define NMEA_COS(x)         cos(x)
+#define NMEA_TAN(x)         tan(x)
+#define NMEA_ASIN(x)        asin(x)
+#define NMEA_ACOS(x)        acos(x)
+#define NMEA_ATAN(x)        atan(x)
+#define NMEA_ATAN2(y, x)    atan2(y, x)
+#define NMEA_SQRT(x)        sqrt(x)
+#define NMEA_POW(x, y)      pow(x, y)
+#define NMEA_MODF(x, i)     modf(x, i)
+#define NMEA_FABS(x)        fabs(x)
+#define NMEA_LROUND(x)      lround(x)
+
+/** the convergence limit of the iterations */
+#define NMEA_GMATH_EPSILON  (1e-12)
+#endif
+
 /**
  * Convert degrees to radians
  *
  * @param val degrees
  * @return radians
  */
-inline double nmea_degree2radian(const double val) {
+inline nmeaFLOAT nmea_degree2radian(const nmeaFLOAT val) {
 	return (val * NMEA_PI180);
 }
 
@@ -35,7 +69,7 @@ inline double nmea_degree2radian(const double val) {
  * @param val radians
  * @return degrees
  */
-inline double nmea_radian2degree(const double val) {
+inline nmeaFLOAT nmea_radian2degree(const nmeaFLOAT val) {
 	return (val / NMEA_PI180);
 }
 
@@ -45,10 +79,10 @@ inline double nmea_radian2degree(const double val) {
  * @param val NDEG (NMEA degrees)
  * @return decimal (fractional) degrees
  */
-inline double nmea_ndeg2degree(const double val) {
-	double deg;
-	double fra_part = modf(val / 100.0, &deg);
-	return (deg + ((fra_part * 100.0) / 60.0));
+inline nmeaFLOAT nmea_ndeg2degree(const nmeaFLOAT val) {
+	nmeaFLOAT deg;
+	nmeaFLOAT fra_part = NMEA_MODF(val / 100, &deg);
+	return (deg + ((fra_part * 100) / 60));
 }
 
 /**
@@ -57,10 +91,10 @@ inline double nmea_ndeg2degree(const double val) {
  * @param val decimal (fractional) degrees
  * @return NDEG (NMEA degrees)
  */
-inline double nmea_degree2ndeg(const double val) {
-	double deg;
-	double fra_part = modf(val, &deg);
-	return ((deg * 100.0) + (fra_part * 60.0));
+inline nmeaFLOAT nmea_degree2ndeg(const nmeaFLOAT val) {
+	nmeaFLOAT deg;
+	nmeaFLOAT fra_part = NMEA_MODF(val, &deg);
+	return ((deg * 100) + (fra_part * 60));
 }
 
 /**
@@ -69,7 +103,7 @@ inline double nmea_degree2ndeg(const double val) {
  * @param val NDEG (NMEA degrees)
  * @return radians
  */
-inline double nmea_ndeg2radian(const double val) {
+inline nmeaFLOAT nmea_ndeg2radian(const nmeaFLOAT val) {
 	return nmea_degree2radian(nmea_ndeg2degree(val));
 }
 
@@ -79,10 +113,51 @@ inline double nmea_ndeg2radian(const double val) {
  * @param val radians
  * @return NDEG (NMEA degrees)
  */
-inline double nmea_radian2ndeg(const double val) {
+inline nmeaFLOAT nmea_radian2ndeg(const nmeaFLOAT val) {
 	return nmea_degree2ndeg(nmea_radian2degree(val));
 }
 
+#if NMEA_FIXED_POINT
+/**
+ * Convert NDEG (NMEA degrees) that is scaled by NMEA_COORD_SCALE to a fixed
+ * point coordinate, using integer arithmetic only
+ *
+ * @param val NDEG (NMEA degrees) multiplied by NMEA_COORD_SCALE
+ * @return the coordinate in units of 1 / NMEA_COORD_SCALE degrees (clamped)
+ */
+nmeaCOORD nmea_ndeg2coord(const int64_t val) {
+	int64_t ndeg = (val < 0) ? -val : val;
+	int64_t deg = ndeg / (100 * (int64_t) NMEA_COORD_SCALE);
+	int64_t min = ndeg % (100 * (int64_t) NMEA_COORD_SCALE);
+	int64_t coord = (deg * NMEA_COORD_SCALE) + ((min + 30) / 60);
+
+	if (coord > INT32_MAX)
+		coord = INT32_MAX;
+
+	return (nmeaCOORD) ((val < 0) ? -coord : coord);
+}
+
+/**
+ * Convert a fixed point coordinate to decimal (fractional) degrees
+ *
+ * @param val the coordinate in units of 1 / NMEA_COORD_SCALE degrees
+ * @return decimal (fractional) degrees
+ */
+inline nmeaFLOAT nmea_coord2degree(const nmeaCOORD val) {
+	return ((nmeaFLOAT) val / NMEA_COORD_SCALE);
+}
+
+/**
+ * Convert decimal (fractional) degrees to a fixed point coordinate
+ *
+ * @param val decimal (fractional) degrees, in [-180, 180]
+ * @return the coordinate in units of 1 / NMEA_COORD_SCALE degrees
+ */
+inline nmeaCOORD nmea_degree2coord(const nmeaFLOAT val) {
+	return (nmeaCOORD) NMEA_LROUND(val * NMEA_COORD_SCALE);
+}
+#endif
+
 /**
  * Calculate PDOP (Position Dilution Of Precision) factor from HDOP and VDOP
  *
@@ -90,8 +165,8 @@ inline double nmea_radian2ndeg(const double val) {
  * @param vdop VDOP
  * @return PDOP
  */
-inline double nmea_calc_pdop(const double hdop, const double vdop) {
-	return sqrt(pow(hdop, 2) + pow(vdop, 2));
+inline nmeaFLOAT nmea_calc_pdop(const nmeaFLOAT hdop, const nmeaFLOAT vdop) {
+	return NMEA_SQRT(NMEA_POW(hdop, 2) + NMEA_POW(vdop, 2));
 }
 
 /**
@@ -100,7 +175,7 @@ inline double nmea_calc_pdop(const double hdop, const double vdop) {
  * @param dop the DOP
  * @return the DOP in meters
  */
-inline double nmea_dop2meters(const double dop) {
+inline nmeaFLOAT nmea_dop2meters(const nmeaFLOAT dop) {
 	return (dop * NMEA_DOP_FACTOR);
 }
 
@@ -110,7 +185,7 @@ inline double nmea_dop2meters(const double dop) {
  * @param meters the DOP in meters
  * @return the plain DOP
  */
-inline double nmea_meters2dop(const double meters) {
+inline nmeaFLOAT nmea_meters2dop(const nmeaFLOAT meters) {
 	return (meters / NMEA_DOP_FACTOR);
 }
 
@@ -121,11 +196,23 @@ inline double nmea_meters2dop(const double meters) {
  * @param to_pos a pointer to the to position (in radians)
  * @return distance in meters
  */
-double nmea_distance(const nmeaPOS *from_pos, const nmeaPOS *to_pos) {
-	return ((double) NMEA_EARTHRADIUS_M)
-			* acos(
-					sin(to_pos->lat) * sin(from_pos->lat)
-							+ cos(to_pos->lat) * cos(from_pos->lat) * cos(to_pos->lon - from_pos->lon));
+nmeaFLOAT nmea_distance(const nmeaPOS *from_pos, const nmeaPOS *to_pos) {
+#if NMEA_SINGLE_PRECISION
+	/* haversine: the acos of the spherical law of cosines looses all precision for short distances in float */
+	nmeaFLOAT sin_dlat = NMEA_SIN((to_pos->lat - from_pos->lat) / 2);
+	nmeaFLOAT sin_dlon = NMEA_SIN((to_pos->lon - from_pos->lon) / 2);
+	nmeaFLOAT h = (sin_dlat * sin_dlat) + (NMEA_COS(from_pos->lat) * NMEA_COS(to_pos->lat) * sin_dlon * sin_dlon);
+
+	if (h > 1)
+		h = 1;
+
+	return ((nmeaFLOAT) NMEA_EARTHRADIUS_M) * 2 * NMEA_ASIN(NMEA_SQRT(h));
+#else
+	return ((nmeaFLOAT) NMEA_EARTHRADIUS_M)
+			* NMEA_ACOS(
+					NMEA_SIN(to_pos->lat) * NMEA_SIN(from_pos->lat)
+							+ NMEA_COS(to_pos->lat) * NMEA_COS(from_pos->lat) * NMEA_COS(to_pos->lon - from_pos->lon));
+#endif
 }
 
 /**
@@ -140,14 +227,14 @@ double nmea_distance(const nmeaPOS *from_pos, const nmeaPOS *to_pos) {
  * @param to_azimuth a pointer to the azimuth at "to" position (in radians) (output)
  * @return distance in meters
  */
-double nmea_distance_ellipsoid(const nmeaPOS *from_pos, const nmeaPOS *to_pos, double *from_azimuth, double *to_azimuth) {
+nmeaFLOAT nmea_distance_ellipsoid(const nmeaPOS *from_pos, const nmeaPOS *to_pos, nmeaFLOAT *from_azimuth, nmeaFLOAT *to_azimuth) {
 	/* All variables */
-	double f, a, b, sqr_a, sqr_b;
-	double L, phi1, phi2, U1, U2, sin_U1, sin_U2, cos_U1, cos_U2;
-	double sigma, sin_sigma, cos_sigma, cos_2_sigmam, sqr_cos_2_sigmam, sqr_cos_alpha, lambda, sin_lambda, cos_lambda,
+	nmeaFLOAT f, a, b, sqr_a, sqr_b;
+	nmeaFLOAT L, phi1, phi2, U1, U2, sin_U1, sin_U2, cos_U1, cos_U2;
+	nmeaFLOAT sigma, sin_sigma, cos_sigma, cos_2_sigmam, sqr_cos_2_sigmam, sqr_cos_alpha, lambda, sin_lambda, cos_lambda,
 			delta_lambda;
 	int remaining_steps;
-	double sqr_u, A, B, delta_sigma, lambda_prev;
+	nmeaFLOAT sqr_u, A, B, delta_sigma, lambda_prev;
 
 	/* Check input */
 	NMEA_ASSERT(from_pos != 0);
@@ -172,54 +259,61 @@ double nmea_distance_ellipsoid(const nmeaPOS *from_pos, const nmeaPOS *to_pos, d
 	L = to_pos->lon - from_pos->lon;
 	phi1 = from_pos->lat;
 	phi2 = to_pos->lat;
-	U1 = atan((1 - f) * tan(phi1));
-	U2 = atan((1 - f) * tan(phi2));
-	sin_U1 = sin(U1);
-	sin_U2 = sin(U2);
-	cos_U1 = cos(U1);
-	cos_U2 = cos(U2);
+	U1 = NMEA_ATAN((1 - f) * NMEA_TAN(phi1));
+	U2 = NMEA_ATAN((1 - f) * NMEA_TAN(phi2));
+	sin_U1 = NMEA_SIN(U1);
+	sin_U2 = NMEA_SIN(U2);
+	cos_U1 = NMEA_COS(U1);
+	cos_U2 = NMEA_COS(U2);
 
 	/* Initialize iteration */
 	sigma = 0;
-	sin_sigma = sin(sigma);
-	cos_sigma = cos(sigma);
+	sin_sigma = NMEA_SIN(sigma);
+	cos_sigma = NMEA_COS(sigma);
 	cos_2_sigmam = 0;
 	sqr_cos_2_sigmam = cos_2_sigmam * cos_2_sigmam;
 	sqr_cos_alpha = 0;
 	lambda = L;
-	sin_lambda = sin(lambda);
-	cos_lambda = cos(lambda);
-	lambda_prev = (double) 2.0 * (double) NMEA_PI;
+	sin_lambda = NMEA_SIN(lambda);
+	cos_lambda = NMEA_COS(lambda);
+	lambda_prev = 2 * NMEA_PI;
 	delta_lambda = lambda_prev - lambda;
 	if (delta_lambda < 0)
 		delta_lambda = -delta_lambda;
 	remaining_steps = 20;
 
-	while ((delta_lambda > 1e-12) && (remaining_steps > 0)) { /* Iterate */
+	while ((delta_lambda > NMEA_GMATH_EPSILON) && (remaining_steps > 0)) { /* Iterate */
 		/* Variables */
-		double tmp1, tmp2, sin_alpha, cos_alpha, C;
+		nmeaFLOAT tmp1, tmp2, sin_alpha, cos_alpha, C;
 
 		/* Calculation */
 		tmp1 = cos_U2 * sin_lambda;
 		tmp2 = cos_U1 * sin_U2 - sin_U1 * cos_U2 * cos_lambda;
-		sin_sigma = sqrt(tmp1 * tmp1 + tmp2 * tmp2);
+		sin_sigma = NMEA_SQRT(tmp1 * tmp1 + tmp2 * tmp2);
+		if (sin_sigma == 0) { /* Coincident on the auxiliary sphere (in float: latitudes 1 ulp apart) */
+			if (from_azimuth != 0)
+				*from_azimuth = 0;
+			if (to_azimuth != 0)
+				*to_azimuth = 0;
+			return 0;
+		}
 		cos_sigma = sin_U1 * sin_U2 + cos_U1 * cos_U2 * cos_lambda;
 		sin_alpha = cos_U1 * cos_U2 * sin_lambda / sin_sigma;
-		cos_alpha = cos(asin(sin_alpha));
+		cos_alpha = NMEA_COS(NMEA_ASIN(sin_alpha));
 		sqr_cos_alpha = cos_alpha * cos_alpha;
 		cos_2_sigmam = cos_sigma - 2 * sin_U1 * sin_U2 / sqr_cos_alpha;
 		sqr_cos_2_sigmam = cos_2_sigmam * cos_2_sigmam;
 		C = f / 16 * sqr_cos_alpha * (4 + f * (4 - 3 * sqr_cos_alpha));
 		lambda_prev = lambda;
-		sigma = asin(sin_sigma);
+		sigma = NMEA_ASIN(sin_sigma);
 		lambda = L
 				+ (1 - C) * f * sin_alpha
 						* (sigma + C * sin_sigma * (cos_2_sigmam + C * cos_sigma * (-1 + 2 * sqr_cos_2_sigmam)));
 		delta_lambda = lambda_prev - lambda;
 		if (delta_lambda < 0)
 			delta_lambda = -delta_lambda;
-		sin_lambda = sin(lambda);
-		cos_lambda = cos(lambda);
+		sin_lambda = NMEA_SIN(lambda);
+		cos_lambda = NMEA_COS(lambda);
 		remaining_steps--;
 	} /* Iterate */
 
@@ -236,12 +330,12 @@ double nmea_distance_ellipsoid(const nmeaPOS *from_pos, const nmeaPOS *to_pos, d
 
 	/* Calculate result */
 	if (from_azimuth != 0) {
-		double tan_alpha_1 = cos_U2 * sin_lambda / (cos_U1 * sin_U2 - sin_U1 * cos_U2 * cos_lambda);
-		*from_azimuth = atan(tan_alpha_1);
+		nmeaFLOAT tan_alpha_1 = cos_U2 * sin_lambda / (cos_U1 * sin_U2 - sin_U1 * cos_U2 * cos_lambda);
+		*from_azimuth = NMEA_ATAN(tan_alpha_1);
 	}
 	if (to_azimuth != 0) {
-		double tan_alpha_2 = cos_U1 * sin_lambda / (-sin_U1 * cos_U2 + cos_U1 * sin_U2 * cos_lambda);
-		*to_azimuth = atan(tan_alpha_2);
+		nmeaFLOAT tan_alpha_2 = cos_U1 * sin_lambda / (-sin_U1 * cos_U2 + cos_U1 * sin_U2 * cos_lambda);
+		*to_azimuth = NMEA_ATAN(tan_alpha_2);
 	}
 
 	return b * A * (sigma - delta_sigma);
@@ -256,16 +350,16 @@ double nmea_distance_ellipsoid(const nmeaPOS *from_pos, const nmeaPOS *to_pos, d
  * @param distance the distance (in km)
  * @return 1 (true) on success, 0 (false) on failure
  */
-int nmea_move_horz(const nmeaPOS *start_pos, nmeaPOS *end_pos, double azimuth, double distance) {
+int nmea_move_horz(const nmeaPOS *start_pos, nmeaPOS *end_pos, nmeaFLOAT azimuth, nmeaFLOAT distance) {
 	nmeaPOS p1 = *start_pos;
 	int RetVal = 1;
 
 	distance /= NMEA_EARTHRADIUS_KM; /* Angular distance covered on earth's surface */
 	azimuth = nmea_degree2radian(azimuth);
 
-	end_pos->lat = asin(sin(p1.lat) * cos(distance) + cos(p1.lat) * sin(distance) * cos(azimuth));
+	end_pos->lat = NMEA_ASIN(NMEA_SIN(p1.lat) * NMEA_COS(distance) + NMEA_COS(p1.lat) * NMEA_SIN(distance) * NMEA_COS(azimuth));
 	end_pos->lon = p1.lon
-			+ atan2(sin(azimuth) * sin(distance) * cos(p1.lat), cos(distance) - sin(p1.lat) * sin(end_pos->lat));
+			+ NMEA_ATAN2(NMEA_SIN(azimuth) * NMEA_SIN(distance) * NMEA_COS(p1.lat), NMEA_COS(distance) - NMEA_SIN(p1.lat) * NMEA_SIN(end_pos->lat));
 
 	if (isnan(end_pos->lat) || isnan(end_pos->lon)) {
 		end_pos->lat = 0;
@@ -289,21 +383,21 @@ int nmea_move_horz(const nmeaPOS *start_pos, nmeaPOS *end_pos, double azimuth, d
  * @param end_azimuth azimuth at end position (in radians) (output)
  * @return 1 (true) on success, 0 (false) on failure
  */
-int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, double azimuth, double distance,
-		double *end_azimuth) {
+int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, nmeaFLOAT azimuth, nmeaFLOAT distance,
+		nmeaFLOAT *end_azimuth) {
 	/* Variables */
-	double f, a, b, sqr_a, sqr_b;
-	double phi1, tan_U1, sin_U1, cos_U1, s, alpha1, sin_alpha1, cos_alpha1;
-	double sigma1, sin_alpha, sqr_cos_alpha, sqr_u, A, B;
-	double sigma_initial, sigma, sigma_prev, sin_sigma, cos_sigma, cos_2_sigmam, sqr_cos_2_sigmam, delta_sigma;
+	nmeaFLOAT f, a, b, sqr_a, sqr_b;
+	nmeaFLOAT phi1, tan_U1, sin_U1, cos_U1, s, alpha1, sin_alpha1, cos_alpha1;
+	nmeaFLOAT sigma1, sin_alpha, sqr_cos_alpha, sqr_u, A, B;
+	nmeaFLOAT sigma_initial, sigma, sigma_prev, sin_sigma, cos_sigma, cos_2_sigmam, sqr_cos_2_sigmam, delta_sigma;
 	int remaining_steps;
-	double tmp1, phi2, lambda, C, L;
+	nmeaFLOAT tmp1, phi2, lambda, C, L;
 
 	/* Check input */
 	NMEA_ASSERT(start_pos != 0);
 	NMEA_ASSERT(end_pos != 0);
 
-	if (fabs(distance) < 1e-12) { /* No move */
+	if (NMEA_FABS(distance) < NMEA_GMATH_EPSILON) { /* No move */
 		*end_pos = *start_pos;
 		if (end_azimuth != 0)
 			*end_azimuth = azimuth;
@@ -319,14 +413,14 @@ int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, double
 
 	/* Calculation */
 	phi1 = start_pos->lat;
-	tan_U1 = (1 - f) * tan(phi1);
-	cos_U1 = 1 / sqrt(1 + tan_U1 * tan_U1);
+	tan_U1 = (1 - f) * NMEA_TAN(phi1);
+	cos_U1 = 1 / NMEA_SQRT(1 + tan_U1 * tan_U1);
 	sin_U1 = tan_U1 * cos_U1;
 	s = distance;
 	alpha1 = azimuth;
-	sin_alpha1 = sin(alpha1);
-	cos_alpha1 = cos(alpha1);
-	sigma1 = atan2(tan_U1, cos_alpha1);
+	sin_alpha1 = NMEA_SIN(alpha1);
+	cos_alpha1 = NMEA_COS(alpha1);
+	sigma1 = NMEA_ATAN2(tan_U1, cos_alpha1);
 	sin_alpha = cos_U1 * sin_alpha1;
 	sqr_cos_alpha = 1 - sin_alpha * sin_alpha;
 	sqr_u = sqr_cos_alpha * (sqr_a - sqr_b) / sqr_b;
@@ -336,19 +430,19 @@ int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, double
 	/* Initialize iteration */
 	sigma_initial = s / (b * A);
 	sigma = sigma_initial;
-	sin_sigma = sin(sigma);
-	cos_sigma = cos(sigma);
-	cos_2_sigmam = cos(2 * sigma1 + sigma);
+	sin_sigma = NMEA_SIN(sigma);
+	cos_sigma = NMEA_COS(sigma);
+	cos_2_sigmam = NMEA_COS(2 * sigma1 + sigma);
 	sqr_cos_2_sigmam = cos_2_sigmam * cos_2_sigmam;
 	delta_sigma = 0;
 	sigma_prev = 2 * NMEA_PI;
 	remaining_steps = 20;
 
-	while ((fabs(sigma - sigma_prev) > 1e-12) && (remaining_steps > 0)) { /* Iterate */
-		cos_2_sigmam = cos(2 * sigma1 + sigma);
+	while ((NMEA_FABS(sigma - sigma_prev) > NMEA_GMATH_EPSILON) && (remaining_steps > 0)) { /* Iterate */
+		cos_2_sigmam = NMEA_COS(2 * sigma1 + sigma);
 		sqr_cos_2_sigmam = cos_2_sigmam * cos_2_sigmam;
-		sin_sigma = sin(sigma);
-		cos_sigma = cos(sigma);
+		sin_sigma = NMEA_SIN(sigma);
+		cos_sigma = NMEA_COS(sigma);
 		delta_sigma = B * sin_sigma
 				* (cos_2_sigmam
 						+ B / 4
@@ -362,9 +456,9 @@ int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, double
 
 	/* Calculate result */
 	tmp1 = (sin_U1 * sin_sigma - cos_U1 * cos_sigma * cos_alpha1);
-	phi2 = atan2(sin_U1 * cos_sigma + cos_U1 * sin_sigma * cos_alpha1,
-			(1 - f) * sqrt(sin_alpha * sin_alpha + tmp1 * tmp1));
-	lambda = atan2(sin_sigma * sin_alpha1, cos_U1 * cos_sigma - sin_U1 * sin_sigma * cos_alpha1);
+	phi2 = NMEA_ATAN2(sin_U1 * cos_sigma + cos_U1 * sin_sigma * cos_alpha1,
+			(1 - f) * NMEA_SQRT(sin_alpha * sin_alpha + tmp1 * tmp1));
+	lambda = NMEA_ATAN2(sin_sigma * sin_alpha1, cos_U1 * cos_sigma - sin_U1 * sin_sigma * cos_alpha1);
 	C = f / 16 * sqr_cos_alpha * (4 + f * (4 - 3 * sqr_cos_alpha));
 	L = lambda
 			- (1 - C) * f * sin_alpha
@@ -374,7 +468,7 @@ int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, double
 	end_pos->lon = start_pos->lon + L;
 	end_pos->lat = phi2;
 	if (end_azimuth != 0) {
-		*end_azimuth = atan2(sin_alpha, -sin_U1 * sin_sigma + cos_U1 * cos_sigma * cos_alpha1);
+		*end_azimuth = NMEA_ATAN2(sin_alpha, -sin_U1 * sin_sigma + cos_U1 * cos_sigma * cos_alpha1);
 	}
 	return !(isnan(end_pos->lat) || isnan(end_pos->lon));
 }
@@ -386,6 +480,17 @@ int nmea_move_horz_ellipsoid(const nmeaPOS *start_pos, nmeaPOS *end_pos, double
  * @param pos a pointer to the radians position (output)
  */
 void nmea_info2pos(const nmeaINFO *info, nmeaPOS *pos) {
+#if NMEA_FIXED_POINT
+	if (nmea_INFO_is_present(info->present, LAT))
+		pos->lat = nmea_degree2radian(nmea_coord2degree(info->lat));
+	else
+		pos->lat = NMEA_DEF_LAT;
+
+	if (nmea_INFO_is_present(info->present, LON))
+		pos->lon = nmea_degree2radian(nmea_coord2degree(info->lon));
+	else
+		pos->lon = NMEA_DEF_LON;
+#else
 	if (nmea_INFO_is_present(info->present, LAT))
 		pos->lat = nmea_ndeg2radian(info->lat);
 	else
@@ -395,6 +500,7 @@ void nmea_info2pos(const nmeaINFO *info, nmeaPOS *pos) {
 		pos->lon = nmea_ndeg2radian(info->lon);
 	else
 		pos->lon = NMEA_DEF_LON;
+#endif
 }
 
 /**
@@ -404,8 +510,13 @@ void nmea_info2pos(const nmeaINFO *info, nmeaPOS *pos) {
  * @param info a pointer to the INFO position (output)
  */
 void nmea_pos2info(const nmeaPOS *pos, nmeaINFO *info) {
+#if NMEA_FIXED_POINT
+	info->lat = nmea_degree2coord(nmea_radian2degree(pos->lat));
+	info->lon = nmea_degree2coord(nmea_radian2degree(pos->lon));
+#else
 	info->lat = nmea_radian2ndeg(pos->lat);
 	info->lon = nmea_radian2ndeg(pos->lon);
+#endif
 	nmea_INFO_set_present(&info->present, LAT);
 	nmea_INFO_set_present(&info->present, LON);
 }
@@ -23,8 +23,27 @@
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
-#include "ch.h"
-#include "hal.h"
+
+#if NMEA_FIXED_POINT
+/** a type for the intermediate results of nmea_INFO_sanitise that does not overflow */
+typedef int64_t nmeaWIDE;
+
+#define NMEA_LAT_MAX        ((nmeaWIDE) 90 * NMEA_COORD_SCALE)  /**< latitude range, 1e-7 degrees */
+#define NMEA_LON_MAX        ((nmeaWIDE) 180 * NMEA_COORD_SCALE) /**< longitude range, 1e-7 degrees */
+#define NMEA_HALF_CIRCLE    ((nmeaWIDE) 180 * NMEA_ANGLE_SCALE) /**< 180 degrees, 1e-2 degrees */
+#define NMEA_ABS(x)         (((x) < 0) ? -(x) : (x))
+#else
+typedef nmeaFLOAT nmeaWIDE;
+
+#define NMEA_LAT_MAX        NMEA_FLOAT(9000.0)  /**< latitude range, NDEG */
+#define NMEA_LON_MAX        NMEA_FLOAT(18000.0) /**< longitude range, NDEG */
+#define NMEA_HALF_CIRCLE    NMEA_FLOAT(180.0)   /**< 180 degrees */
+#if NMEA_SINGLE_PRECISION
+#define NMEA_ABS(x)         fabsf(x)
+#else
+#define NMEA_ABS(x)         fabs(x)
+#endif
+#endif
 
 void nmea_INFO_set_connection(nmeaINFO *info, int connection) {
     info->connection = connection;
@@ -44,6 +63,7 @@ bool nmea_INFO_has_fix(nmeaINFO *info) {
     return (info->fix > NMEA_FIX_BAD);
 }
 
+#if NMEA_PLATFORM == NMEA_PLATFORM_CHIBIOS
 /**
  * Determine the day of the week for any Gregorian date
  * by Tomohiko Sakamoto (via Wikipedia)
@@ -88,6 +108,7 @@ void nmea_INFO2time(nmeaINFO *info, RTCDateTime *timespec, long int timezone) {
     timespec->millisecond += NMEA_MILLIS_IN_DAY;
   }
 }
+#endif
 
 /**
  * Reset the time to now
@@ -98,13 +119,11 @@ void nmea_INFO2time(nmeaINFO *info, RTCDateTime *timespec, long int timezone) {
  */
 void nmea_time_now(nmeaTIME *utc, uint32_t * present) {
 	struct tm tt;
-	RTCDateTime timespec;
 	uint32_t tv_msec;
 
 	NMEA_ASSERT(utc);
 
-    rtcGetTime(&RTCD1, &timespec);
-    rtcConvertDateTimeToStructTm(&timespec, &tt, &tv_msec);
+	nmea_platform_time(&tt, &tv_msec);
 
 	utc->year = tt.tm_year;
 	utc->mon = tt.tm_mon;
@@ -229,21 +248,344 @@ void nmea_INFO_unset_present(uint32_t * present, nmeaINFO_FIELD fieldName) {
 	*present &= ~fieldName;
 }
 
+/*
+ * Bits of the per entry bitmaps (changed, stale) of nmeaSATINFO
+ */
+
+static inline bool _nmea_sat_bit(const uint32_t *bitmap, const int entry) {
+	return ((bitmap[entry / 32] & (1u << (entry % 32))) != 0);
+}
+
+static inline void _nmea_sat_bit_set(uint32_t *bitmap, const int entry) {
+	bitmap[entry / 32] |= 1u << (entry % 32);
+}
+
+static inline void _nmea_sat_bit_clear(uint32_t *bitmap, const int entry) {
+	bitmap[entry / 32] &= ~(1u << (entry % 32));
+}
+
+/**
+ * Forget which fields of a nmeaINFO structure changed. nmea_parse does this
+ * at the start of every call, after which merging sentences into the
+ * structure flags the fields of which the value changes or that become
+ * present, and the satellites in view that change (or move within sat).
+ *
+ * @param info a pointer to the nmeaINFO structure
+ */
+void nmea_INFO_clear_changed(nmeaINFO *info) {
+	NMEA_ASSERT(info);
+	info->changed = 0;
+	memset(&info->satinfo.changed, 0, sizeof(info->satinfo.changed));
+}
+
+/**
+ * Determine if a field of a nmeaINFO structure changed
+ *
+ * @param info a pointer to the nmeaINFO structure
+ * @param fieldName use a name from nmeaINFO_FIELD
+ * @return a boolean, true when the field changed since nmea_INFO_clear_changed
+ */
+bool nmea_INFO_is_changed(const nmeaINFO *info, nmeaINFO_FIELD fieldName) {
+	NMEA_ASSERT(info);
+	return ((info->changed & fieldName) != 0);
+}
+
+/**
+ * Determine if an entry of the satellites in view changed
+ *
+ * @param satinfo a pointer to the satellites information
+ * @param entry the index of the entry in sat
+ * @return a boolean, true when the entry changed since nmea_INFO_clear_changed
+ */
+bool nmea_INFO_sat_is_changed(const nmeaSATINFO *satinfo, const int entry) {
+	NMEA_ASSERT(satinfo);
+
+	if ((entry < 0) || (entry >= NMEA_MAXSAT)) {
+		return false;
+	}
+
+	return _nmea_sat_bit(satinfo->changed, entry);
+}
+
+/**
+ * Determine the slot of the satellite index at which the search for a
+ * satellite starts. The signal is not part of the hash, so that all signals
+ * of a satellite are found by probing from the same slot.
+ *
+ * @param system the satellite system
+ * @param id the satellite PRN number
+ * @return the slot
+ */
+static inline unsigned int _nmea_sat_hash(const int system, const int id) {
+	return (unsigned int) ((((uint32_t) ((system << 10) ^ id) * 2654435761u) >> 16) % NMEA_SATINDEX);
+}
+
+/**
+ * Add an entry of the satellites in view to the satellite index
+ *
+ * @param satinfo a pointer to the satellites information
+ * @param entry the index of the entry in sat
+ */
+static void _nmea_sat_index_add(nmeaSATINFO *satinfo, const int entry) {
+	unsigned int slot = _nmea_sat_hash(satinfo->sat[entry].system, satinfo->sat[entry].id);
+
+	/* the index is at most half full, so there always is an empty slot */
+	while (satinfo->index[slot]) {
+		slot = (slot + 1) % NMEA_SATINDEX;
+	}
+
+	satinfo->index[slot] = (uint8_t) (entry + 1);
+}
+
+/**
+ * Rebuild the satellite index from the satellites in view
+ *
+ * @param satinfo a pointer to the satellites information
+ */
+static void _nmea_sat_reindex(nmeaSATINFO *satinfo) {
+	int entry;
+
+	memset(&satinfo->index, 0, sizeof(satinfo->index));
+	for (entry = 0; entry < satinfo->inview; entry++) {
+		_nmea_sat_index_add(satinfo, entry);
+	}
+}
+
+/**
+ * Determine the satellite system of a satellite by its PRN number, for
+ * sentences of the combined (GN) talker that do not carry a system ID (before
+ * NMEA 4.10). Those report GLONASS satellites as 65-96 and all others as GPS.
+ *
+ * @param id the satellite PRN number
+ * @return the satellite system (see nmeaSYSTEM)
+ */
+int nmea_INFO_sat_system(const int id) {
+	if ((id >= 65) && (id <= 96)) {
+		return SYSTEM_GLONASS;
+	}
+
+	return SYSTEM_GPS;
+}
+
+/**
+ * Find a satellite in view, in constant time
+ *
+ * @param satinfo a pointer to the satellites information
+ * @param system the satellite system (see nmeaSYSTEM)
+ * @param id the satellite PRN number
+ * @param signal the signal ID, or -1 to find the satellite for any signal
+ * @return a pointer to the satellite, NULL when it is not in view
+ */
+nmeaSATELLITE * nmea_INFO_sat_find(nmeaSATINFO *satinfo, const int system, const int id, const int signal) {
+	unsigned int slot;
+	int probes;
+
+	NMEA_ASSERT(satinfo);
+
+	slot = _nmea_sat_hash(system, id);
+	for (probes = 0; (probes < NMEA_SATINDEX) && satinfo->index[slot]; probes++) {
+		nmeaSATELLITE *sat = &satinfo->sat[satinfo->index[slot] - 1];
+
+		if ((sat->id == id) && (sat->system == system) && ((signal < 0) || (sat->signal == signal))) {
+			return sat;
+		}
+
+		slot = (slot + 1) % NMEA_SATINDEX;
+	}
+
+	return NULL;
+}
+
+/**
+ * Update a satellite in view, or add it when it is not in view yet
+ *
+ * @param satinfo a pointer to the satellites information
+ * @param sat a pointer to the satellite, identified by its system, id and signal
+ * @return true when the satellite was stored, false when the store is full
+ */
+bool nmea_INFO_sat_update(nmeaSATINFO *satinfo, const nmeaSATELLITE *sat) {
+	nmeaSATELLITE *entry;
+
+	NMEA_ASSERT(satinfo);
+	NMEA_ASSERT(sat);
+
+	entry = nmea_INFO_sat_find(satinfo, sat->system, sat->id, sat->signal);
+	if (entry) {
+		_nmea_sat_bit_clear(satinfo->stale, (int) (entry - satinfo->sat));
+		if (memcmp(entry, sat, sizeof(*entry))) {
+			*entry = *sat;
+			_nmea_sat_bit_set(satinfo->changed, (int) (entry - satinfo->sat));
+		}
+		return true;
+	}
+
+	if (satinfo->inview >= NMEA_MAXSAT) {
+		return false;
+	}
+
+	satinfo->sat[satinfo->inview] = *sat;
+	_nmea_sat_index_add(satinfo, satinfo->inview);
+	_nmea_sat_bit_set(satinfo->changed, satinfo->inview);
+	satinfo->inview++;
+
+	return true;
+}
+
+/**
+ * Mark the satellites in view of a system and signal as stale, as a new cycle
+ * of GSV sentences for them starts. Updating a satellite makes it fresh again
+ * (see nmea_INFO_sat_update), nmea_INFO_sat_sweep removes the satellites that
+ * remained stale at the end of the cycle. The satellites stay in view during
+ * the cycle, so that they do not change when they are reported unchanged.
+ *
+ * @param satinfo a pointer to the satellites information
+ * @param system the satellite system (see nmeaSYSTEM)
+ * @param signal the signal ID
+ */
+void nmea_INFO_sat_mark(nmeaSATINFO *satinfo, const int system, const int signal) {
+	int entry;
+
+	NMEA_ASSERT(satinfo);
+
+	for (entry = 0; entry < satinfo->inview; entry++) {
+		if ((satinfo->sat[entry].system == system) && (satinfo->sat[entry].signal == signal)) {
+			_nmea_sat_bit_set(satinfo->stale, entry);
+		}
+	}
+}
+
+/**
+ * Remove the satellites in view of a system and signal that are stale (see
+ * nmea_INFO_sat_mark), as a cycle of GSV sentences for them ends
+ *
+ * @param satinfo a pointer to the satellites information
+ * @param system the satellite system (see nmeaSYSTEM)
+ * @param signal the signal ID
+ */
+void nmea_INFO_sat_sweep(nmeaSATINFO *satinfo, const int system, const int signal) {
+	int from;
+	int to = 0;
+
+	NMEA_ASSERT(satinfo);
+
+	for (from = 0; from < satinfo->inview; from++) {
+		bool stale = _nmea_sat_bit(satinfo->stale, from);
+
+		if (stale && (satinfo->sat[from].system == system) && (satinfo->sat[from].signal == signal)) {
+			continue;
+		}
+
+		if (to != from) {
+			satinfo->sat[to] = satinfo->sat[from];
+			if (stale) {
+				_nmea_sat_bit_set(satinfo->stale, to);
+			} else {
+				_nmea_sat_bit_clear(satinfo->stale, to);
+			}
+			_nmea_sat_bit_set(satinfo->changed, to);
+		}
+		to++;
+	}
+
+	if (to == satinfo->inview) {
+		return;
+	}
+
+	for (from = to; from < satinfo->inview; from++) {
+		_nmea_sat_bit_clear(satinfo->stale, from);
+		_nmea_sat_bit_set(satinfo->changed, from);
+	}
+	memset(&satinfo->sat[to], 0, (size_t) (satinfo->inview - to) * sizeof(satinfo->sat[0]));
+	satinfo->inview = to;
+	_nmea_sat_reindex(satinfo);
+}
+
+/**
+ * Replace the satellites in use of a system
+ *
+ * @param satinfo a pointer to the satellites information
+ * @param system the satellite system (see nmeaSYSTEM), SYSTEM_UNKNOWN to
+ * determine the system of every satellite by its PRN number (see
+ * nmea_INFO_sat_system)
+ * @param ids the PRN numbers of the satellites in use (0 for unused entries)
+ * @param count the number of entries in ids
+ * @return true when the satellites in use changed
+ */
+bool nmea_INFO_sat_use(nmeaSATINFO *satinfo, const int system, const int *ids, const int count) {
+	uint32_t systems = 0;
+	bool changed = false;
+	int used = 0;
+	int from;
+	int to = 0;
+	int i;
+
+	NMEA_ASSERT(satinfo);
+	NMEA_ASSERT(ids);
+
+	/* the systems of which the satellites in use are replaced */
+	for (i = 0; i < count; i++) {
+		if (ids[i]) {
+			systems |= 1u << (system ? system : nmea_INFO_sat_system(ids[i]));
+		}
+	}
+
+	/* not bounded by inuse, GGA sentences set it to their own count */
+	for (from = 0; from < NMEA_MAXSAT; from++) {
+		if (!satinfo->in_use[from].id) {
+			continue;
+		}
+
+		used++;
+		if (systems & (1u << satinfo->in_use[from].system)) {
+			continue;
+		}
+
+		if (to != from) {
+			satinfo->in_use[to] = satinfo->in_use[from];
+			changed = true;
+		}
+		to++;
+	}
+
+	for (i = 0; (i < count) && (to < NMEA_MAXSAT); i++) {
+		if (ids[i]) {
+			int idSystem = system ? system : nmea_INFO_sat_system(ids[i]);
+
+			if ((satinfo->in_use[to].system != idSystem) || (satinfo->in_use[to].id != ids[i])) {
+				satinfo->in_use[to].system = idSystem;
+				satinfo->in_use[to].id = ids[i];
+				changed = true;
+			}
+			to++;
+		}
+	}
+
+	if (to != used) {
+		changed = true;
+	}
+
+	memset(&satinfo->in_use[to], 0, (size_t) (NMEA_MAXSAT - to) * sizeof(satinfo->in_use[0]));
+	satinfo->inuse = to;
+
+	return changed;
+}
+
 /**
  * Sanitise the NMEA info, make sure that:
  * - sig is in the range [0, 8],
  * - fix is in the range [1, 3],
  * - DOPs are positive,
- * - latitude is in the range [-9000, 9000],
- * - longitude is in the range [-18000, 18000],
+ * - latitude is in the range [-9000, 9000] ([-90, 90] degrees in fixed point mode),
+ * - longitude is in the range [-18000, 18000] ([-180, 180] degrees in fixed point mode),
  * - speed is positive,
  * - track is in the range [0, 360>.
  * - mtrack is in the range [0, 360>.
  * - magvar is in the range [0, 360>.
  * - satinfo:
  *   - inuse and in_use are consistent (w.r.t. count)
- *   - inview and sat are consistent (w.r.t. count/id)
- *   - in_use and sat are consistent (w.r.t. count/id)
+ *   - inview and sat are consistent (w.r.t. count/id), the satellites in view
+ *     are at the start of sat and the satellite index is rebuilt
+ *   - in_use and sat are consistent (w.r.t. count/system/id)
  *   - elv is in the range [0, 90]
  *   - azimuth is in the range [0, 359]
  *   - sig is in the range [0, 99]
@@ -255,21 +597,23 @@ void nmea_INFO_unset_present(uint32_t * present, nmeaINFO_FIELD fieldName) {
  * the NMEA info structure to sanitise
  */
 void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
-	double lat = 0;
-	double lon = 0;
-	double speed = 0;
-	double track = 0;
-	double mtrack = 0;
-	double magvar = 0;
+	nmeaWIDE lat = 0;
+	nmeaWIDE lon = 0;
+	nmeaWIDE speed = 0;
+	nmeaWIDE track = 0;
+	nmeaWIDE mtrack = 0;
+	nmeaWIDE magvar = 0;
 	bool latAdjusted = false;
 	bool lonAdjusted = false;
 	bool speedAdjusted = false;
 	bool trackAdjusted = false;
 	bool mtrackAdjusted = false;
 	bool magvarAdjusted = false;
-	nmeaTIME utc;
+	nmeaTIME utc = { 0 };
 	int inuseIndex;
+	int inuseCount;
 	int inviewIndex;
+	int inviewCount;
 
 	if (!nmeaInfo) {
 		return;
@@ -317,19 +661,19 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	if (!nmea_INFO_is_present(nmeaInfo->present, PDOP)) {
 		nmeaInfo->PDOP = 0;
 	} else {
-		nmeaInfo->PDOP = fabs(nmeaInfo->PDOP);
+		nmeaInfo->PDOP = NMEA_ABS(nmeaInfo->PDOP);
 	}
 
 	if (!nmea_INFO_is_present(nmeaInfo->present, HDOP)) {
 		nmeaInfo->HDOP = 0;
 	} else {
-		nmeaInfo->HDOP = fabs(nmeaInfo->HDOP);
+		nmeaInfo->HDOP = NMEA_ABS(nmeaInfo->HDOP);
 	}
 
 	if (!nmea_INFO_is_present(nmeaInfo->present, VDOP)) {
 		nmeaInfo->VDOP = 0;
 	} else {
-		nmeaInfo->VDOP = fabs(nmeaInfo->VDOP);
+		nmeaInfo->VDOP = NMEA_ABS(nmeaInfo->VDOP);
 	}
 
 	if (!nmea_INFO_is_present(nmeaInfo->present, LAT)) {
@@ -379,29 +723,29 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	lon = nmeaInfo->lon;
 
 	/* force lat in [-18000, 18000] */
-	while (lat < -18000.0) {
-		lat += 36000.0;
+	while (lat < -NMEA_LON_MAX) {
+		lat += 2 * NMEA_LON_MAX;
 		latAdjusted = true;
 	}
-	while (lat > 18000.0) {
-		lat -= 36000.0;
+	while (lat > NMEA_LON_MAX) {
+		lat -= 2 * NMEA_LON_MAX;
 		latAdjusted = true;
 	}
 
 	/* lat is now in [-18000, 18000] */
 
 	/* force lat from <9000, 18000] in [9000, 0] */
-	if (lat > 9000.0) {
-		lat = 18000.0 - lat;
-		lon += 18000.0;
+	if (lat > NMEA_LAT_MAX) {
+		lat = NMEA_LON_MAX - lat;
+		lon += NMEA_LON_MAX;
 		latAdjusted = true;
 		lonAdjusted = true;
 	}
 
 	/* force lat from [-18000, -9000> in [0, -9000] */
-	if (lat < -9000.0) {
-		lat = -18000.0 - lat;
-		lon += 18000.0;
+	if (lat < -NMEA_LAT_MAX) {
+		lat = -NMEA_LON_MAX - lat;
+		lon += NMEA_LON_MAX;
 		latAdjusted = true;
 		lonAdjusted = true;
 	}
@@ -417,12 +761,12 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	 */
 
 	/* force lon in [-18000, 18000] */
-	while (lon < -18000.0) {
-		lon += 36000.0;
+	while (lon < -NMEA_LON_MAX) {
+		lon += 2 * NMEA_LON_MAX;
 		lonAdjusted = true;
 	}
-	while (lon > 18000.0) {
-		lon -= 36000.0;
+	while (lon > NMEA_LON_MAX) {
+		lon -= 2 * NMEA_LON_MAX;
 		lonAdjusted = true;
 	}
 
@@ -440,10 +784,10 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	track = nmeaInfo->track;
 	mtrack = nmeaInfo->mtrack;
 
-	if (speed < 0.0) {
+	if (speed < 0) {
 		speed = -speed;
-		track += 180.0;
-		mtrack += 180.0;
+		track += NMEA_HALF_CIRCLE;
+		mtrack += NMEA_HALF_CIRCLE;
 		speedAdjusted = true;
 		trackAdjusted = true;
 		mtrackAdjusted = true;
@@ -460,12 +804,12 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	 */
 
 	/* force track in [0, 360> */
-	while (track < 0.0) {
-		track += 360.0;
+	while (track < 0) {
+		track += 2 * NMEA_HALF_CIRCLE;
 		trackAdjusted = true;
 	}
-	while (track >= 360.0) {
-		track -= 360.0;
+	while (track >= (2 * NMEA_HALF_CIRCLE)) {
+		track -= 2 * NMEA_HALF_CIRCLE;
 		trackAdjusted = true;
 	}
 
@@ -480,12 +824,12 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	 */
 
 	/* force mtrack in [0, 360> */
-	while (mtrack < 0.0) {
-		mtrack += 360.0;
+	while (mtrack < 0) {
+		mtrack += 2 * NMEA_HALF_CIRCLE;
 		mtrackAdjusted = true;
 	}
-	while (mtrack >= 360.0) {
-		mtrack -= 360.0;
+	while (mtrack >= (2 * NMEA_HALF_CIRCLE)) {
+		mtrack -= 2 * NMEA_HALF_CIRCLE;
 		mtrackAdjusted = true;
 	}
 
@@ -502,12 +846,12 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	magvar = nmeaInfo->magvar;
 
 	/* force magvar in [0, 360> */
-	while (magvar < 0.0) {
-		magvar += 360.0;
+	while (magvar < 0) {
+		magvar += 2 * NMEA_HALF_CIRCLE;
 		magvarAdjusted = true;
 	}
-	while (magvar >= 360.0) {
-		magvar -= 360.0;
+	while (magvar >= (2 * NMEA_HALF_CIRCLE)) {
+		magvar -= 2 * NMEA_HALF_CIRCLE;
 		magvarAdjusted = true;
 	}
 
@@ -521,87 +865,83 @@ void nmea_INFO_sanitise(nmeaINFO *nmeaInfo) {
 	 * satinfo
 	 */
 
-	nmeaInfo->satinfo.inuse = 0;
-	for (inuseIndex = 0; inuseIndex < NMEA_MAXSAT; inuseIndex++) {
-		if (nmeaInfo->satinfo.in_use[inuseIndex])
-			nmeaInfo->satinfo.inuse++;
-	}
-
-	nmeaInfo->satinfo.inview = 0;
+	/* keep the satellites in view at the start of sat */
+	inviewCount = 0;
 	for (inviewIndex = 0; inviewIndex < NMEA_MAXSAT; inviewIndex++) {
 		if (nmeaInfo->satinfo.sat[inviewIndex].id) {
-			nmeaInfo->satinfo.inview++;
+			nmeaSATELLITE *sat = &nmeaInfo->satinfo.sat[inviewCount];
+
+			if (inviewCount != inviewIndex) {
+				*sat = nmeaInfo->satinfo.sat[inviewIndex];
+				memset(&nmeaInfo->satinfo.sat[inviewIndex], 0, sizeof(nmeaInfo->satinfo.sat[inviewIndex]));
+			}
+			inviewCount++;
 
 			/* force elv in [-180, 180] */
-			while (nmeaInfo->satinfo.sat[inviewIndex].elv < -180) {
-				nmeaInfo->satinfo.sat[inviewIndex].elv += 360;
+			while (sat->elv < -180) {
+				sat->elv += 360;
 			}
-			while (nmeaInfo->satinfo.sat[inviewIndex].elv > 180) {
-				nmeaInfo->satinfo.sat[inviewIndex].elv -= 360;
+			while (sat->elv > 180) {
+				sat->elv -= 360;
 			}
 
 			/* elv is now in [-180, 180] */
 
 			/* force elv from <90, 180] in [90, 0] */
-			if (nmeaInfo->satinfo.sat[inviewIndex].elv > 90) {
-				nmeaInfo->satinfo.sat[inviewIndex].elv = 180 - nmeaInfo->satinfo.sat[inviewIndex].elv;
+			if (sat->elv > 90) {
+				sat->elv = 180 - sat->elv;
 			}
 
 			/* force elv from [-180, -90> in [0, -90] */
-			if (nmeaInfo->satinfo.sat[inviewIndex].elv < -90) {
-				nmeaInfo->satinfo.sat[inviewIndex].elv = -180 - nmeaInfo->satinfo.sat[inviewIndex].elv;
+			if (sat->elv < -90) {
+				sat->elv = -180 - sat->elv;
 			}
 
 			/* elv is now in [-90, 90] */
 
-			if (nmeaInfo->satinfo.sat[inviewIndex].elv < 0) {
-				nmeaInfo->satinfo.sat[inviewIndex].elv = -nmeaInfo->satinfo.sat[inviewIndex].elv;
+			if (sat->elv < 0) {
+				sat->elv = -sat->elv;
 			}
 
 			/* elv is now in [0, 90] */
 
 			/* force azimuth in [0, 360> */
-			while (nmeaInfo->satinfo.sat[inviewIndex].azimuth < 0) {
-				nmeaInfo->satinfo.sat[inviewIndex].azimuth += 360;
+			while (sat->azimuth < 0) {
+				sat->azimuth += 360;
 			}
-			while (nmeaInfo->satinfo.sat[inviewIndex].azimuth >= 360) {
-				nmeaInfo->satinfo.sat[inviewIndex].azimuth -= 360;
+			while (sat->azimuth >= 360) {
+				sat->azimuth -= 360;
 			}
 			/* azimuth is now in [0, 360> */
 
 			/* force sig in [0, 99] */
-			if (nmeaInfo->satinfo.sat[inviewIndex].sig < 0)
-				nmeaInfo->satinfo.sat[inviewIndex].sig = 0;
-			if (nmeaInfo->satinfo.sat[inviewIndex].sig > 99)
-				nmeaInfo->satinfo.sat[inviewIndex].sig = 99;
+			if (sat->sig < 0)
+				sat->sig = 0;
+			if (sat->sig > 99)
+				sat->sig = 99;
 		}
 	}
+	nmeaInfo->satinfo.inview = inviewCount;
+	memset(&nmeaInfo->satinfo.stale, 0, sizeof(nmeaInfo->satinfo.stale));
+	_nmea_sat_reindex(&nmeaInfo->satinfo);
 
-	/* make sure the in_use IDs map to sat IDs */
+	/* keep the in_use IDs that map to sat IDs at the start of in_use */
+	inuseCount = 0;
 	for (inuseIndex = 0; inuseIndex < NMEA_MAXSAT; inuseIndex++) {
-		int inuseID = nmeaInfo->satinfo.in_use[inuseIndex];
-		if (inuseID) {
-			bool found = false;
-			for (inviewIndex = 0; inviewIndex < NMEA_MAXSAT; inviewIndex++) {
-				int inviewID = nmeaInfo->satinfo.sat[inviewIndex].id;
-				if (inuseID == inviewID) {
-					found = true;
-					break;
-				}
-			}
-			if (!found) {
-				/* clear the id, did not find it */
-				nmeaInfo->satinfo.in_use[inuseIndex] = 0;
-				if (nmeaInfo->satinfo.inuse)
-					nmeaInfo->satinfo.inuse--;
-			}
+		nmeaSATID inuse = nmeaInfo->satinfo.in_use[inuseIndex];
+
+		memset(&nmeaInfo->satinfo.in_use[inuseIndex], 0, sizeof(nmeaInfo->satinfo.in_use[inuseIndex]));
+		if (inuse.id && nmea_INFO_sat_find(&nmeaInfo->satinfo, inuse.system, inuse.id, -1)) {
+			nmeaInfo->satinfo.in_use[inuseCount++] = inuse;
 		}
 	}
+	nmeaInfo->satinfo.inuse = inuseCount;
 }
 
 /**
  * Converts the position fields to degrees and DOP fields to meters so that
- * all fields use normal metric units.
+ * all fields use normal metric units. In fixed point mode the position fields
+ * are already in degrees and the DOP fields become centimeters.
  *
  * @param nmeaInfo
  * the nmeaINFO
@@ -618,6 +958,23 @@ void nmea_INFO_unit_conversion(nmeaINFO * nmeaInfo) {
 	/* sig (already in correct format) */
 	/* fix (already in correct format) */
 
+#if NMEA_FIXED_POINT
+	/* DOP * NMEA_DOP_SCALE (100) to centimeters */
+	if (nmea_INFO_is_present(nmeaInfo->present, PDOP)) {
+		nmeaInfo->PDOP *= NMEA_DOP_FACTOR;
+	}
+
+	if (nmea_INFO_is_present(nmeaInfo->present, HDOP)) {
+		nmeaInfo->HDOP *= NMEA_DOP_FACTOR;
+	}
+
+	if (nmea_INFO_is_present(nmeaInfo->present, VDOP)) {
+		nmeaInfo->VDOP *= NMEA_DOP_FACTOR;
+	}
+
+	/* lat (already in degrees) */
+	/* lon (already in degrees) */
+#else
 	if (nmea_INFO_is_present(nmeaInfo->present, PDOP)) {
 		nmeaInfo->PDOP = nmea_dop2meters(nmeaInfo->PDOP);
 	}
@@ -637,6 +994,7 @@ void nmea_INFO_unit_conversion(nmeaINFO * nmeaInfo) {
 	if (nmea_INFO_is_present(nmeaInfo->present, LON)) {
 		nmeaInfo->lon = nmea_ndeg2degree(nmeaInfo->lon);
 	}
+#endif
 
 	/* elv (already in correct format) */
 	/* speed (already in correct format) */
@@ -17,6 +17,7 @@
 
 #include <nmea/parse.h>
 
+#include <nmea/error.h>
 #include <nmea/gmath.h>
 #include <nmea/tok.h>
 
@@ -25,6 +26,29 @@
 #include <ctype.h>
 #include <stdio.h>
 
+#if NMEA_FIXED_POINT
+/** the value of an absent fixed point field (never the result of a parse) */
+#define NMEA_NONE           INT32_MIN
+#define nmea_isnone(v)      ((v) == NMEA_NONE)
+#else
+/** the value of an absent floating point field */
+#define NMEA_NONE           NAN
+#define nmea_isnone(v)      isnan(v)
+#endif
+
+/** the two characters of a talker as an integer */
+#define NMEA_TALKER_ID(a, b)          (((uint32_t) (unsigned char) (a) << 8) | (uint32_t) (unsigned char) (b))
+
+/** the three characters of a sentence formatter as an integer */
+#define NMEA_FORMATTER_ID(a, b, c)    (((uint32_t) (unsigned char) (a) << 16) | NMEA_TALKER_ID(b, c))
+
+/** meters per hour in a knot */
+#define NMEA_KNOTS_MPH      (1852)
+
+/** meters per hour in a kilometer per hour */
+#define NMEA_KPH_MPH        (1000)
+
+#if NMEA_SENTENCE_GGA || NMEA_SENTENCE_RMC
 /**
  * Parse nmeaTIME (time only, no date) from a string.
  * The format that is used (hhmmss, hhmmss.s, hhmmss.ss or hhmmss.sss) is
@@ -41,36 +65,42 @@ static bool _nmea_parse_time(const char *s, const int len, nmeaTIME *t) {
 
 #if NMEA_TIME_FORMAT == 1
   if (len == (sizeof("hhmmss") - 1)) {
+    t->hour = nmea_atoi(&s[0], 2, 10);
+    t->min = nmea_atoi(&s[2], 2, 10);
+    t->sec = nmea_atoi(&s[4], 2, 10);
     t->hsec = 0;
-    return (3 == nmea_scanf(s, len, "%2d%2d%2d", &t->hour, &t->min, &t->sec));
+    return true;
   }
 #elif NMEA_TIME_FORMAT == 2
-  if (len == (sizeof("hhmmss.s") - 1)) {
-    if (4 == nmea_scanf(s, len, "%2d%2d%2d.%d", &t->hour, &t->min, &t->sec, &t->hsec)) {
-      t->hsec *= 10;
-      return true;
-    }
-    return false;
+  if ((len == (sizeof("hhmmss.s") - 1)) && (s[6] == '.')) {
+    t->hour = nmea_atoi(&s[0], 2, 10);
+    t->min = nmea_atoi(&s[2], 2, 10);
+    t->sec = nmea_atoi(&s[4], 2, 10);
+    t->hsec = nmea_atoi(&s[7], 1, 10) * 10;
+    return true;
   }
 #elif NMEA_TIME_FORMAT == 3
-  if (len == (sizeof("hhmmss.ss") - 1)) {
-    return (4 == nmea_scanf(s, len, "%2d%2d%2d.%d", &t->hour, &t->min, &t->sec, &t->hsec));
+  if ((len == (sizeof("hhmmss.ss") - 1)) && (s[6] == '.')) {
+    t->hour = nmea_atoi(&s[0], 2, 10);
+    t->min = nmea_atoi(&s[2], 2, 10);
+    t->sec = nmea_atoi(&s[4], 2, 10);
+    t->hsec = nmea_atoi(&s[7], 2, 10);
+    return true;
   }
 #elif NMEA_TIME_FORMAT == 4
-  if (len == (sizeof("hhmmss.sss") - 1)) {
-    if ((4 == nmea_scanf(s, len, "%2d%2d%2d.%d", &t->hour, &t->min, &t->sec, &t->hsec))) {
-      t->hsec = (t->hsec + 9) / 10;
-      return true;
-    }
-    return false;
+  if ((len == (sizeof("hhmmss.sss") - 1)) && (s[6] == '.')) {
+    t->hour = nmea_atoi(&s[0], 2, 10);
+    t->min = nmea_atoi(&s[2], 2, 10);
+    t->sec = nmea_atoi(&s[4], 2, 10);
+    t->hsec = (nmea_atoi(&s[7], 3, 10) + 9) / 10;
+    return true;
   }
-#endif
-#if NMEA_ERROR
-  nmea_error("Parse error: invalid time format in %s", s);
 #endif
   return false;
 }
+#endif
 
+#if NMEA_SENTENCE_RMC
 /**
  * Parse nmeaTIME (date only, no time) from a string.
  * The month is adjusted -1 to comply with the nmeaTIME month range of [0, 11].
@@ -85,9 +115,6 @@ static bool _nmea_parse_date(const int date, nmeaTIME *t) {
   NMEA_ASSERT(t);
 
   if ((date < 0) || (date > 999999)) {
-#if NMEA_ERROR
-    nmea_error("Parse error: invalid time format in %d", date);
-#endif
     return false;
   }
 
@@ -101,8 +128,9 @@ static bool _nmea_parse_date(const int date, nmeaTIME *t) {
 
   return true;
 }
+#endif
 
-#if NMEA_VALIDATE
+#if NMEA_SENTENCE_GGA || NMEA_SENTENCE_RMC
 /**
  * Validate the time fields in an nmeaTIME structure.
  * Expects:
@@ -123,9 +151,6 @@ static bool validateTime(const nmeaTIME * t) {
 
   if (!((t->hour >= 0) && (t->hour < 24) && (t->min >= 0) && (t->min < 60) && (t->sec >= 0) && (t->sec <= 60)
       && (t->hsec >= 0) && (t->hsec < 100))) {
-#if NMEA_ERROR
-    nmea_error("Parse error: invalid time (%d:%d:%d.%d)", t->hour, t->min, t->sec, t->hsec);
-#endif
     return false;
   }
 
@@ -133,7 +158,7 @@ static bool validateTime(const nmeaTIME * t) {
 }
 #endif
 
-#if NMEA_VALIDATE
+#if NMEA_SENTENCE_RMC
 /**
  * Validate the date fields in an nmeaTIME structure.
  * Expects:
@@ -152,9 +177,6 @@ static bool validateDate(const nmeaTIME * t) {
   }
 
   if (!((t->year >= 90) && (t->year <= 189) && (t->mon >= 0) && (t->mon <= 11) && (t->day >= 1) && (t->day <= 31))) {
-#if NMEA_ERROR
-    nmea_error("Parse error: invalid date (%d-%d-%d - D-M-Y)", t->day, t->mon, t->year);
-#endif
     return false;
   }
 
@@ -162,7 +184,7 @@ static bool validateDate(const nmeaTIME * t) {
 }
 #endif
 
-#if NMEA_VALIDATE
+#if NMEA_SENTENCE_GGA || NMEA_SENTENCE_RMC
 /**
  * Validate north/south or east/west and uppercase it.
  * Expects:
@@ -184,16 +206,10 @@ static bool validateNSEW(char * c, const bool ns) {
 
   if (ns) {
     if (!((*c == 'N') || (*c == 'S'))) {
-#if NMEA_ERROR
-      nmea_error("Parse error: invalid north/south (%c)", *c);
-#endif
       return false;
     }
   } else {
     if (!((*c == 'E') || (*c == 'W'))) {
-#if NMEA_ERROR
-      nmea_error("Parse error: invalid east/west (%c)", *c);
-#endif
       return false;
     }
   }
@@ -202,7 +218,7 @@ static bool validateNSEW(char * c, const bool ns) {
 }
 #endif
 
-#if NMEA_VALIDATE
+#if NMEA_SENTENCE_RMC
 /**
  * Uppercase mode and validate it.
  * Expects:
@@ -234,9 +250,6 @@ static bool validateMode(char * c) {
 
   if (!((*c == 'A') || (*c == 'D') || (*c == 'E') || (*c == 'F') || (*c == 'M') || (*c == 'N') || (*c == 'P')
       || (*c == 'R') || (*c == 'S'))) {
-#if NMEA_ERROR
-    nmea_error("Parse error: invalid mode (%c)", *c);
-#endif
     return false;
   }
 
@@ -310,154 +323,536 @@ char nmea_parse_sentence_has_invalid_chars(const char * s, const size_t len) {
 }
 
 /**
- * Determine sentence type (see nmeaPACKTYPE) by the header of a string.
+ * Split a sentence into its comma separated fields, walking the string once.
+ * Field 0 is the address field ('$' followed by the header), the last field
+ * ends at the '*' that precedes the checksum (or at the end of the string).
+ * Fields beyond NMEA_MAXFIELDS are not split off and are ignored, as is
+ * anything beyond the first 255 characters (a valid sentence is at most 82).
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param fields a pointer to the structure in which to store the fields
+ * @return the number of tokens (fields that follow the address field)
+ */
+int nmea_parse_fields(const char *s, const int len, nmeaFIELDS *fields) {
+  const char *end = s + ((len > UINT8_MAX) ? UINT8_MAX : len);
+  const char *p = s;
+  int count = 0;
+  uint32_t nonempty = 0;
+
+  NMEA_ASSERT(s);
+  NMEA_ASSERT(fields);
+
+  while (count < NMEA_MAXFIELDS) {
+    const char *start = p;
+
+    while ((p < end) && (*p != ',') && (*p != '*')) {
+      p++;
+    }
+
+    fields->field[count].offset = (uint8_t) (start - s);
+    fields->field[count].length = (uint8_t) (p - start);
+    nonempty |= (uint32_t) (p != start) << count;
+    count++;
+
+    if ((p >= end) || (*p != ',')) {
+      break;
+    }
+    p++;
+  }
+
+  fields->count = count;
+  fields->nonempty = nonempty;
+  return count - 1;
+}
+
+/**
+ * Get a field of a sentence, without copying it.
+ *
+ * @param s the string that was split by nmea_parse_fields
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field (0 is the address field)
+ * @param len a pointer to the length of the field (output), 0 when the field is absent
+ * @return a pointer to the start of the field (not NUL-terminated), or NULL when absent
+ */
+const char * nmea_parse_field(const char *s, const nmeaFIELDS *fields, const int index, int *len) {
+  NMEA_ASSERT(s);
+  NMEA_ASSERT(fields);
+  NMEA_ASSERT(len);
+
+  if ((index < 0) || (index >= fields->count)) {
+    *len = 0;
+    return NULL;
+  }
+
+  *len = fields->field[index].length;
+  return &s[fields->field[index].offset];
+}
+
+/**
+ * Determine whether the address field of a sentence is a header with the
+ * given sentence formatter, from any of the supported talkers.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @param formatter the sentence formatter (like "GGA")
+ * @return true when the address field matches the formatter
+ */
+static inline bool _nmea_field_header(const char *s, const nmeaFIELDS *fields, const char *formatter) {
+  const char *header = &s[fields->field[0].offset];
+
+  return ((fields->field[0].length == 6) && (header[0] == '$')
+      && (nmea_parse_get_talker(&header[1], 2) != TALKER_NONE) && !memcmp(&header[3], formatter, 3));
+}
+
+/**
+ * Determine whether a field is present: not empty and not absent.
+ *
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field
+ * @return true when the field is present
+ */
+static inline bool _nmea_field_present(const nmeaFIELDS *fields, const int index) {
+  return (fields->nonempty >> index) & 1;
+}
+
+/**
+ * The nmeaINFO field of a field of a sentence, for VALIDATE_NONE
+ */
+typedef struct _nmeaPRESENCE {
+  uint32_t info;      /**< The nmeaINFO field (see nmeaINFO_FIELD), 0 for none */
+  uint8_t companion;  /**< The field that must not be empty either (the hemisphere of a value), 0 for none */
+} nmeaPRESENCE;
+
+/**
+ * Determine the present nmeaINFO fields of a sentence from the emptiness of its
+ * fields alone, without looking at their values (VALIDATE_NONE). A value with
+ * a hemisphere is present only with its hemisphere, which gives its sign.
+ *
+ * @param fields a pointer to the fields of the string
+ * @param map the nmeaINFO field of each field of the sentence
+ * @param count the number of entries of map
+ * @return the present mask
+ */
+static uint32_t _nmea_fields_present(const nmeaFIELDS *fields, const nmeaPRESENCE *map, const int count) {
+  uint32_t present = 0;
+  int i;
+
+  for (i = 1; i < count; i++) {
+    if (_nmea_field_present(fields, i) && (!map[i].companion || _nmea_field_present(fields, map[i].companion))) {
+      present |= map[i].info;
+    }
+  }
+
+  return present;
+}
+
+#if !NMEA_FIXED_POINT
+/**
+ * Store a non-empty field as a floating point number.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field
+ * @param v a pointer to the number, untouched when the field is empty or absent
+ */
+static inline void _nmea_field_float(const char *s, const nmeaFIELDS *fields, const int index, nmeaFLOAT *v) {
+  if ((index < fields->count) && fields->field[index].length) {
+    *v = nmea_atof(&s[fields->field[index].offset], fields->field[index].length);
+  }
+}
+#endif
+
+#if NMEA_FIXED_POINT
+/**
+ * Clamp a fixed point number to an int32_t, keeping clear of NMEA_NONE.
+ *
+ * @param v the number
+ * @return the clamped number
+ */
+static inline int32_t _nmea_fixed_clamp(const int64_t v) {
+  if (v > INT32_MAX) {
+    return INT32_MAX;
+  }
+  if (v < -INT32_MAX) {
+    return -INT32_MAX;
+  }
+  return (int32_t) v;
+}
+
+/**
+ * Store a non-empty field as a fixed point number.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field
+ * @param scale the scale of the number (a power of 10)
+ * @param v a pointer to the number, untouched when the field is empty or absent
+ */
+static inline void _nmea_field_fixed(const char *s, const nmeaFIELDS *fields, const int index, const int32_t scale,
+    int32_t *v) {
+  if ((index < fields->count) && fields->field[index].length) {
+    *v = _nmea_fixed_clamp(nmea_atofixed(&s[fields->field[index].offset], fields->field[index].length, scale));
+  }
+}
+
+/**
+ * Store a non-empty NDEG (NMEA degrees) field as a fixed point coordinate.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field
+ * @param v a pointer to the coordinate, untouched when the field is empty or absent
+ */
+static inline void _nmea_field_coord(const char *s, const nmeaFIELDS *fields, const int index, nmeaCOORD *v) {
+  if ((index < fields->count) && fields->field[index].length) {
+    *v = nmea_ndeg2coord(nmea_atofixed(&s[fields->field[index].offset], fields->field[index].length, NMEA_COORD_SCALE));
+  }
+}
+
+/**
+ * Store a non-empty speed field as a fixed point speed.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field
+ * @param mph the unit of the field, in meters per hour
+ * @param v a pointer to the speed, untouched when the field is empty or absent
+ */
+static inline void _nmea_field_speed(const char *s, const nmeaFIELDS *fields, const int index, const int mph,
+    nmeaSPEED *v) {
+  if ((index < fields->count) && fields->field[index].length) {
+    /* the field in 1/1000 of its unit, to meters per hour, to nmeaSPEED */
+    int64_t speed = (int64_t) _nmea_fixed_clamp(
+        nmea_atofixed(&s[fields->field[index].offset], fields->field[index].length, 1000)) * mph * NMEA_SPEED_SCALE;
+    int64_t div = 1000 * 3600;
+    *v = _nmea_fixed_clamp((speed + ((speed < 0) ? -(div / 2) : (div / 2))) / div);
+  }
+}
+
+#define _nmea_field_length(s, fields, index, v)   _nmea_field_fixed((s), (fields), (index), NMEA_LENGTH_SCALE, (v))
+#define _nmea_field_angle(s, fields, index, v)    _nmea_field_fixed((s), (fields), (index), NMEA_ANGLE_SCALE, (v))
+#define _nmea_field_dop(s, fields, index, v)      _nmea_field_fixed((s), (fields), (index), NMEA_DOP_SCALE, (v))
+#define _nmea_field_duration(s, fields, index, v) _nmea_field_fixed((s), (fields), (index), NMEA_DURATION_SCALE, (v))
+#else
+#define _nmea_field_coord(s, fields, index, v)    _nmea_field_float((s), (fields), (index), (v))
+#define _nmea_field_speed(s, fields, index, mph, v) _nmea_field_float((s), (fields), (index), (v))
+#define _nmea_field_length(s, fields, index, v)   _nmea_field_float((s), (fields), (index), (v))
+#define _nmea_field_angle(s, fields, index, v)    _nmea_field_float((s), (fields), (index), (v))
+#define _nmea_field_dop(s, fields, index, v)      _nmea_field_float((s), (fields), (index), (v))
+#define _nmea_field_duration(s, fields, index, v) _nmea_field_float((s), (fields), (index), (v))
+#endif
+
+/**
+ * Store a non-empty field as a decimal integer.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field
+ * @param v a pointer to the integer, untouched when the field is empty or absent
+ */
+static inline void _nmea_field_int(const char *s, const nmeaFIELDS *fields, const int index, int *v) {
+  if ((index < fields->count) && fields->field[index].length) {
+    *v = nmea_atoi(&s[fields->field[index].offset], fields->field[index].length, 10);
+  }
+}
+
+/**
+ * Store a non-empty field as a character.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @param index the index of the field
+ * @param v a pointer to the character, untouched when the field is empty or absent
+ * @return false when the field is longer than a single character
+ */
+static inline bool _nmea_field_char(const char *s, const nmeaFIELDS *fields, const int index, char *v) {
+  if (index >= fields->count) {
+    return true;
+  }
+
+  if (fields->field[index].length > 1) {
+    return false;
+  }
+
+  if (fields->field[index].length) {
+    *v = s[fields->field[index].offset];
+  }
+
+  return true;
+}
+
+/**
+ * Determine the talker (see nmeaTALKER) by the header of a string.
  * The header is the start of an NMEA sentence, right after the $.
  *
  * @param s the string. must be the NMEA string, right after the initial $
  * @param len the length of the string
+ * @return The talker (or TALKER_NONE when it is not supported)
+ */
+enum nmeaTALKER nmea_parse_get_talker(const char *s, const int len) {
+  NMEA_ASSERT(s);
+
+  if (len < 2) {
+    return TALKER_NONE;
+  }
+
+  switch (NMEA_TALKER_ID(s[0], s[1])) {
+    case NMEA_TALKER_ID('G', 'P'):
+      return TALKER_GP;
+
+    case NMEA_TALKER_ID('G', 'N'):
+      return TALKER_GN;
+
+    case NMEA_TALKER_ID('G', 'L'):
+      return TALKER_GL;
+
+    case NMEA_TALKER_ID('G', 'A'):
+      return TALKER_GA;
+
+    case NMEA_TALKER_ID('G', 'B'):
+    case NMEA_TALKER_ID('B', 'D'):
+      return TALKER_GB;
+
+    case NMEA_TALKER_ID('G', 'Q'):
+      return TALKER_GQ;
+
+    default:
+      return TALKER_NONE;
+  }
+}
+
+#if NMEA_SENTENCE_GSA || NMEA_SENTENCE_GSV
+/**
+ * Determine the satellite system (see nmeaSYSTEM) of the satellites in a
+ * sentence from its talker.
+ *
+ * @param s the string
+ * @param fields a pointer to the fields of the string
+ * @return the satellite system, SYSTEM_UNKNOWN for the combined (GN) talker
+ */
+static int _nmea_field_system(const char *s, const nmeaFIELDS *fields) {
+  switch (nmea_parse_get_talker(&s[fields->field[0].offset + 1], fields->field[0].length - 1)) {
+    case TALKER_GP:
+      return SYSTEM_GPS;
+
+    case TALKER_GL:
+      return SYSTEM_GLONASS;
+
+    case TALKER_GA:
+      return SYSTEM_GALILEO;
+
+    case TALKER_GB:
+      return SYSTEM_BEIDOU;
+
+    case TALKER_GQ:
+      return SYSTEM_QZSS;
+
+    default:
+      return SYSTEM_UNKNOWN;
+  }
+}
+#endif
+
+/**
+ * Determine sentence type (see nmeaPACKTYPE) by the header of a string.
+ * The header is the start of an NMEA sentence, right after the $. The type
+ * is determined by the sentence formatter (the last three characters of the
+ * header) for all supported talkers (see nmea_parse_get_talker), so a GNGGA
+ * sentence is of type GPGGA.
+ *
+ * @param s the string. must be the NMEA string, right after the initial $
+ * @param len the length of the string
  * @return The packet type (or GPNON when it could not be determined)
  */
 enum nmeaPACKTYPE nmea_parse_get_sentence_type(const char *s, const int len) {
-  static const char *pheads[] = { "GPGGA", "GPGSA", "GPGSV", "GPRMC", "GPVTG" };
-  static const enum nmeaPACKTYPE types[] = { GPGGA, GPGSA, GPGSV, GPRMC, GPVTG };
-  unsigned int i;
-
   NMEA_ASSERT(s);
 
-  if (len < 5) {
+  if ((len < 5) || (nmea_parse_get_talker(s, len) == TALKER_NONE)) {
     return GPNON;
   }
 
-  for (i = 0; i < (sizeof(types) / sizeof(types[0])); i++) {
-    if (!memcmp(s, pheads[i], 5)) {
-      return types[i];
-    }
-  }
+  switch (NMEA_FORMATTER_ID(s[2], s[3], s[4])) {
+    case NMEA_FORMATTER_ID('G', 'G', 'A'):
+      return GPGGA;
+
+    case NMEA_FORMATTER_ID('G', 'S', 'A'):
+      return GPGSA;
+
+    case NMEA_FORMATTER_ID('G', 'S', 'V'):
+      return GPGSV;
 
-  return GPNON;
+    case NMEA_FORMATTER_ID('R', 'M', 'C'):
+      return GPRMC;
+
+    case NMEA_FORMATTER_ID('V', 'T', 'G'):
+      return GPVTG;
+
+    default:
+      return GPNON;
+  }
 }
 
+#if NMEA_SENTENCE_GGA
+/** the nmeaINFO field of each GGA field, for VALIDATE_NONE */
+static const nmeaPRESENCE gga_present[] = {
+    [1] = { UTCTIME, 0 },
+    [2] = { LAT, 3 },
+    [4] = { LON, 5 },
+    [6] = { SIG, 0 },
+    [7] = { SATINUSECOUNT, 0 },
+    [8] = { HDOP, 0 },
+    [9] = { ELV, 0 }
+};
+
 /**
- * Parse a GPGGA sentence from a string
+ * Parse a GPGGA sentence from a string that was split into fields
  *
  * @param s the string
  * @param len the length of the string
- * @param has_checksum true when the string contains a checksum
+ * @param fields a pointer to the fields of the string (see nmea_parse_fields)
+ * @param validation the validation level (see nmeaVALIDATION)
  * @param pack a pointer to the result structure
  * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
  */
-int nmea_parse_GPGGA(const char *s, const int len, bool has_checksum, nmeaGPGGA *pack) {
+int nmea_parse_GPGGA_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPGGA *pack) {
   int token_count;
-  char time_buff[NMEA_TIMEPARSE_BUF];
-  size_t time_buff_len = 0;
-
-  if (!has_checksum) {
-    return 0;
-  }
+  uint32_t malformed = 0;
 
   NMEA_ASSERT(s);
+  NMEA_ASSERT(fields);
   NMEA_ASSERT(pack);
 
+  /* the fields hold the offsets and lengths */
+  (void) len;
+
   /*
-   * Clear before parsing, to be able to detect absent fields
+   * Clear before parsing, full validation marks the absent fields
    */
-#if !NMEA_VALIDATE
-  memset(pack, 0, sizeof(nmeaGPGGA));
-#else
-  time_buff[0] = '\0';
-  pack->present = 0;
-  pack->utc.hour = -1;
-  pack->utc.min = -1;
-  pack->utc.sec = -1;
-  pack->utc.hsec = -1;
-  pack->lat = NAN;
-  pack->ns = 0;
-  pack->lon = NAN;
-  pack->ew = 0;
-  pack->sig = -1;
-  pack->satinuse = -1;
-  pack->HDOP = NAN;
-  pack->elv = NAN;
-  pack->elv_units = 0;
-  pack->diff = 0;     /* ignored */
-  pack->diff_units = 0; /* ignored */
-  pack->dgps_age = 0;   /* ignored */
-  pack->dgps_sid = 0;   /* ignored */
-#endif
+  if (validation != VALIDATE_FULL) {
+    memset(pack, 0, sizeof(nmeaGPGGA));
+  } else {
+    pack->present = 0;
+    pack->utc.hour = -1;
+    pack->utc.min = -1;
+    pack->utc.sec = -1;
+    pack->utc.hsec = -1;
+    pack->lat = NMEA_NONE;
+    pack->ns = 0;
+    pack->lon = NMEA_NONE;
+    pack->ew = 0;
+    pack->sig = -1;
+    pack->satinuse = -1;
+    pack->HDOP = NMEA_NONE;
+    pack->elv = NMEA_NONE;
+    pack->elv_units = 0;
+    pack->diff = 0;     /* ignored */
+    pack->diff_units = 0; /* ignored */
+    pack->dgps_age = 0;   /* ignored */
+    pack->dgps_sid = 0;   /* ignored */
+  }
 
   /* parse */
-  token_count = nmea_scanf(s, len, "$GPGGA,%s,%f,%c,%f,%c,%d,%d,%f,%f,%c,%f,%c,%f,%d*", &time_buff[0], &pack->lat,
-      &pack->ns, &pack->lon, &pack->ew, &pack->sig, &pack->satinuse, &pack->HDOP, &pack->elv, &pack->elv_units,
-      &pack->diff, &pack->diff_units, &pack->dgps_age, &pack->dgps_sid);
+  token_count = fields->count - 1;
 
   /* see that we have enough tokens */
-  if (token_count != 14) {
+  if ((token_count < 14) || !_nmea_field_header(s, fields, "GGA") || !_nmea_field_char(s, fields, 3, &pack->ns)
+      || !_nmea_field_char(s, fields, 5, &pack->ew) || !_nmea_field_char(s, fields, 10, &pack->elv_units)
+      || !_nmea_field_char(s, fields, 12, &pack->diff_units)) {
 #if NMEA_ERROR
-    nmea_error("GPGGA parse error: need 14 tokens, got %d in %s", token_count, s);
+    nmea_error_record(PARSE_ERROR_TOKENS, GPGGA, 0, token_count);
 #endif
     return 0;
   }
 
-  /* determine which fields are present and validate them */
-
-  time_buff_len = strlen(&time_buff[0]);
-  if (time_buff_len > (NMEA_TIMEPARSE_BUF - 1))
-    time_buff_len = NMEA_TIMEPARSE_BUF - 1;
-  if (time_buff_len) {
-    if (!_nmea_parse_time(&time_buff[0], time_buff_len, &pack->utc)) {
+  _nmea_field_coord(s, fields, 2, &pack->lat);
+  _nmea_field_coord(s, fields, 4, &pack->lon);
+  _nmea_field_int(s, fields, 6, &pack->sig);
+  _nmea_field_int(s, fields, 7, &pack->satinuse);
+  _nmea_field_dop(s, fields, 8, &pack->HDOP);
+  _nmea_field_length(s, fields, 9, &pack->elv);
+  _nmea_field_length(s, fields, 11, &pack->diff);
+  _nmea_field_duration(s, fields, 13, &pack->dgps_age);
+  _nmea_field_int(s, fields, 14, &pack->dgps_sid);
+
+  if (_nmea_field_present(fields, 1)
+      && !_nmea_parse_time(&s[fields->field[1].offset], fields->field[1].length, &pack->utc)) {
+    if (validation != VALIDATE_NONE) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_TIME_FORMAT, GPGGA, 1, fields->field[1].length);
+#endif
       return 0;
     }
 
-#if NMEA_VALIDATE
-    if (!validateTime(&pack->utc)) {
+    /* without validation a malformed time is absent */
+    malformed |= UTCTIME;
+  }
+
+  if (validation == VALIDATE_NONE) {
+    pack->present = _nmea_fields_present(fields, gga_present, (int) (sizeof(gga_present) / sizeof(gga_present[0])))
+        & ~malformed;
+    return 1;
+  }
+
+  /* determine which fields are present and validate them */
+
+  if (_nmea_field_present(fields, 1)) {
+    if ((validation == VALIDATE_FULL) && !validateTime(&pack->utc)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_TIME, GPGGA, 1, (pack->utc.hour * 10000) + (pack->utc.min * 100) + pack->utc.sec);
+#endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, UTCTIME);
-#endif
   }
-#if NMEA_VALIDATE
-  if (!isnan(pack->lat) && (pack->ns)) {
-    if (!validateNSEW(&pack->ns, true)) {
+  if (_nmea_field_present(fields, 2) && (pack->ns)) {
+    if ((validation == VALIDATE_FULL) && !validateNSEW(&pack->ns, true)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_DIRECTION, GPGGA, 3, pack->ns);
+#endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, LAT);
   }
-  if (!isnan(pack->lon) && (pack->ew)) {
-    if (!validateNSEW(&pack->ew, false)) {
+  if (_nmea_field_present(fields, 4) && (pack->ew)) {
+    if ((validation == VALIDATE_FULL) && !validateNSEW(&pack->ew, false)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_DIRECTION, GPGGA, 5, pack->ew);
+#endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, LON);
   }
-  if (pack->sig != -1) {
-    if (!((pack->sig >= NMEA_SIG_FIRST) && (pack->sig <= NMEA_SIG_LAST))) {
+  if (_nmea_field_present(fields, 6)) {
+    if ((validation == VALIDATE_FULL) && !((pack->sig >= NMEA_SIG_FIRST) && (pack->sig <= NMEA_SIG_LAST))) {
 #if NMEA_ERROR
-      nmea_error("GPGGA parse error: invalid signal %d, expected [%d, %d]", pack->sig, NMEA_SIG_FIRST, NMEA_SIG_LAST);
+      nmea_error_record(PARSE_ERROR_SIGNAL, GPGGA, 6, pack->sig);
 #endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, SIG);
   }
-  if (pack->satinuse != -1) {
+  if (_nmea_field_present(fields, 7)) {
     nmea_INFO_set_present(&pack->present, SATINUSECOUNT);
   }
-  if (!isnan(pack->HDOP)) {
+  if (_nmea_field_present(fields, 8)) {
     nmea_INFO_set_present(&pack->present, HDOP);
   }
-  if (!isnan(pack->elv) && (pack->elv_units)) {
-    if (pack->elv_units != 'M') {
+  if (_nmea_field_present(fields, 9) && (pack->elv_units)) {
+    if ((validation == VALIDATE_FULL) && (pack->elv_units != 'M')) {
 #if NMEA_ERROR
-      nmea_error("GPGGA parse error: invalid elevation unit (%c)", pack->elv_units);
+      nmea_error_record(PARSE_ERROR_UNIT, GPGGA, 10, pack->elv_units);
 #endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, ELV);
   }
-#endif
   /* ignore diff and diff_units */
   /* ignore dgps_age and dgps_sid */
 
@@ -465,7 +860,7 @@ int nmea_parse_GPGGA(const char *s, const int len, bool has_checksum, nmeaGPGGA
 }
 
 /**
- * Parse a GPGSA sentence from a string
+ * Parse a GPGGA sentence from a string
  *
  * @param s the string
  * @param len the length of the string
@@ -473,90 +868,158 @@ int nmea_parse_GPGGA(const char *s, const int len, bool has_checksum, nmeaGPGGA
  * @param pack a pointer to the result structure
  * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
  */
-int nmea_parse_GPGSA(const char *s, const int len, bool has_checksum, nmeaGPGSA *pack) {
-  int token_count;
+int nmea_parse_GPGGA(const char *s, const int len, bool has_checksum, nmeaGPGGA *pack) {
+  nmeaFIELDS fields;
 
   if (!has_checksum) {
     return 0;
   }
 
   NMEA_ASSERT(s);
+
+  nmea_parse_fields(s, len, &fields);
+  return nmea_parse_GPGGA_fields(s, len, &fields, VALIDATE_FULL, pack);
+}
+#endif
+
+#if NMEA_SENTENCE_GSA
+/** the nmeaINFO field of each GSA field, for VALIDATE_NONE */
+static const nmeaPRESENCE gsa_present[] = {
+    [2] = { FIX, 0 },
+    [3] = { SATINUSE, 0 }, [4] = { SATINUSE, 0 }, [5] = { SATINUSE, 0 }, [6] = { SATINUSE, 0 },
+    [7] = { SATINUSE, 0 }, [8] = { SATINUSE, 0 }, [9] = { SATINUSE, 0 }, [10] = { SATINUSE, 0 },
+    [11] = { SATINUSE, 0 }, [12] = { SATINUSE, 0 }, [13] = { SATINUSE, 0 }, [14] = { SATINUSE, 0 },
+    [15] = { PDOP, 0 },
+    [16] = { HDOP, 0 },
+    [17] = { VDOP, 0 }
+};
+
+/**
+ * Parse a GPGSA sentence from a string that was split into fields
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param fields a pointer to the fields of the string (see nmea_parse_fields)
+ * @param validation the validation level (see nmeaVALIDATION)
+ * @param pack a pointer to the result structure
+ * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
+ */
+int nmea_parse_GPGSA_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPGSA *pack) {
+  int token_count;
+  int i;
+
+  NMEA_ASSERT(s);
+  NMEA_ASSERT(fields);
   NMEA_ASSERT(pack);
 
+  /* the fields hold the offsets and lengths */
+  (void) len;
+
   /*
-   * Clear before parsing, to be able to detect absent fields
+   * Clear before parsing, full validation marks the absent fields
    */
-#if !NMEA_VALIDATE
-  memset(pack, 0, sizeof(nmeaGPGSA));
-#else
-  pack->present = 0;
-  pack->fix_mode = 0;
-  pack->fix_type = -1;
-  int i;
-  for (i = 0; i < NMEA_MAXSAT; i++) {
-    pack->sat_prn[i] = 0;
+  if (validation != VALIDATE_FULL) {
+    memset(pack, 0, sizeof(nmeaGPGSA));
+  } else {
+    pack->present = 0;
+    pack->fix_mode = 0;
+    pack->fix_type = -1;
+    for (i = 0; i < NMEA_SATINGSA; i++) {
+      pack->sat_prn[i] = 0;
+    }
+    pack->PDOP = NMEA_NONE;
+    pack->HDOP = NMEA_NONE;
+    pack->VDOP = NMEA_NONE;
+    pack->system = SYSTEM_UNKNOWN;
   }
-  pack->PDOP = NAN;
-  pack->HDOP = NAN;
-  pack->VDOP = NAN;
-#endif
 
   /* parse */
-  token_count = nmea_scanf(s, len, "$GPGSA,%c,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%f,%f,%f*", &pack->fix_mode,
-      &pack->fix_type, &pack->sat_prn[0], &pack->sat_prn[1], &pack->sat_prn[2], &pack->sat_prn[3],
-      &pack->sat_prn[4], &pack->sat_prn[5], &pack->sat_prn[6], &pack->sat_prn[7], &pack->sat_prn[8],
-      &pack->sat_prn[9], &pack->sat_prn[10], &pack->sat_prn[11], &pack->PDOP, &pack->HDOP, &pack->VDOP);
+  token_count = fields->count - 1;
 
   /* see that we have enough tokens */
-  if (token_count != 17) {
+  if ((token_count < 17) || !_nmea_field_header(s, fields, "GSA") || !_nmea_field_char(s, fields, 1, &pack->fix_mode)) {
+#if NMEA_ERROR
+    nmea_error_record(PARSE_ERROR_TOKENS, GPGSA, 0, token_count);
+#endif
+    return 0;
+  }
+
+  _nmea_field_int(s, fields, 2, &pack->fix_type);
+  _nmea_field_int(s, fields, 3, &pack->sat_prn[0]);
+  _nmea_field_int(s, fields, 4, &pack->sat_prn[1]);
+  _nmea_field_int(s, fields, 5, &pack->sat_prn[2]);
+  _nmea_field_int(s, fields, 6, &pack->sat_prn[3]);
+  _nmea_field_int(s, fields, 7, &pack->sat_prn[4]);
+  _nmea_field_int(s, fields, 8, &pack->sat_prn[5]);
+  _nmea_field_int(s, fields, 9, &pack->sat_prn[6]);
+  _nmea_field_int(s, fields, 10, &pack->sat_prn[7]);
+  _nmea_field_int(s, fields, 11, &pack->sat_prn[8]);
+  _nmea_field_int(s, fields, 12, &pack->sat_prn[9]);
+  _nmea_field_int(s, fields, 13, &pack->sat_prn[10]);
+  _nmea_field_int(s, fields, 14, &pack->sat_prn[11]);
+  _nmea_field_dop(s, fields, 15, &pack->PDOP);
+  _nmea_field_dop(s, fields, 16, &pack->HDOP);
+  _nmea_field_dop(s, fields, 17, &pack->VDOP);
+
+  /* the system ID of NMEA 4.10, or the system of the talker */
+  pack->system = _nmea_field_system(s, fields);
+  _nmea_field_int(s, fields, 18, &pack->system);
+  if ((pack->system < SYSTEM_UNKNOWN) || (pack->system > SYSTEM_LAST)) {
 #if NMEA_ERROR
-    nmea_error("GPGSA parse error: need 17 tokens, got %d in %s", token_count, s);
+    nmea_error_record(PARSE_ERROR_SYSTEM, GPGSA, 18, pack->system);
 #endif
     return 0;
   }
 
-#if NMEA_VALIDATE
+  if (validation == VALIDATE_NONE) {
+    pack->present = _nmea_fields_present(fields, gsa_present, (int) (sizeof(gsa_present) / sizeof(gsa_present[0])));
+    return 1;
+  }
+
   /* determine which fields are present and validate them */
 
-  pack->fix_mode = toupper((unsigned char)pack->fix_mode);
-  if (!((pack->fix_mode == 'A') || (pack->fix_mode == 'M'))) {
+  if (validation == VALIDATE_FULL) {
+    pack->fix_mode = toupper((unsigned char)pack->fix_mode);
+    if (!((pack->fix_mode == 'A') || (pack->fix_mode == 'M'))) {
 #if NMEA_ERROR
-    nmea_error("GPGSA parse error: invalid fix mode (%c)", pack->fix_mode);
+      nmea_error_record(PARSE_ERROR_FIX_MODE, GPGSA, 1, pack->fix_mode);
 #endif
-    return 0;
+      return 0;
+    }
   }
-  if (pack->fix_type != -1) {
-    if (!((pack->fix_type >= NMEA_FIX_FIRST) && (pack->fix_type <= NMEA_FIX_LAST))) {
+  if (_nmea_field_present(fields, 2)) {
+    if ((validation == VALIDATE_FULL)
+        && !((pack->fix_type >= NMEA_FIX_FIRST) && (pack->fix_type <= NMEA_FIX_LAST))) {
 #if NMEA_ERROR
-      nmea_error("GPGSA parse error: invalid fix type %d, expected [%d, %d]", pack->fix_type, NMEA_FIX_FIRST, NMEA_FIX_LAST);
+      nmea_error_record(PARSE_ERROR_FIX_TYPE, GPGSA, 2, pack->fix_type);
 #endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, FIX);
   }
-  for (i = 0; i < NMEA_MAXSAT; i++) {
+  for (i = 0; i < NMEA_SATINGSA; i++) {
     if (pack->sat_prn[i] != 0) {
       nmea_INFO_set_present(&pack->present, SATINUSE);
       break;
     }
   }
-  if (!isnan(pack->PDOP)) {
+  if (_nmea_field_present(fields, 15)) {
     nmea_INFO_set_present(&pack->present, PDOP);
   }
-  if (!isnan(pack->HDOP)) {
+  if (_nmea_field_present(fields, 16)) {
     nmea_INFO_set_present(&pack->present, HDOP);
   }
-  if (!isnan(pack->VDOP)) {
+  if (_nmea_field_present(fields, 17)) {
     nmea_INFO_set_present(&pack->present, VDOP);
   }
-#endif
 
   return 1;
 }
 
 /**
- * Parse a GPGSV sentence from a string
+ * Parse a GPGSA sentence from a string
  *
  * @param s the string
  * @param len the length of the string
@@ -564,41 +1027,93 @@ int nmea_parse_GPGSA(const char *s, const int len, bool has_checksum, nmeaGPGSA
  * @param pack a pointer to the result structure
  * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
  */
-int nmea_parse_GPGSV(const char *s, const int len, bool has_checksum, nmeaGPGSV *pack) {
-  int token_count;
-  int token_count_expected;
-  int sat_count;
-  int sat_counted = 0;
+int nmea_parse_GPGSA(const char *s, const int len, bool has_checksum, nmeaGPGSA *pack) {
+  nmeaFIELDS fields;
 
   if (!has_checksum) {
     return 0;
   }
 
   NMEA_ASSERT(s);
+
+  nmea_parse_fields(s, len, &fields);
+  return nmea_parse_GPGSA_fields(s, len, &fields, VALIDATE_FULL, pack);
+}
+#endif
+
+#if NMEA_SENTENCE_GSV
+/**
+ * Parse a GPGSV sentence from a string that was split into fields
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param fields a pointer to the fields of the string (see nmea_parse_fields)
+ * @param validation the validation level (see nmeaVALIDATION)
+ * @param pack a pointer to the result structure
+ * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
+ */
+int nmea_parse_GPGSV_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPGSV *pack) {
+  int token_count;
+  int token_count_expected;
+  int sat_count;
+  int sat_counted = 0;
+
+  NMEA_ASSERT(s);
+  NMEA_ASSERT(fields);
   NMEA_ASSERT(pack);
 
+  /* the fields hold the offsets and lengths */
+  (void) len;
+
   /*
    * Clear before parsing, to be able to detect absent fields
    */
   memset(pack, 0, sizeof(nmeaGPGSV));
 
   /* parse */
-  token_count = nmea_scanf(s, len, "$GPGSV,%d,%d,%d,"
-      "%d,%d,%d,%d,"
-      "%d,%d,%d,%d,"
-      "%d,%d,%d,%d,"
-      "%d,%d,%d,%d*", &pack->pack_count, &pack->pack_index, &pack->sat_count, &pack->sat_data[0].id,
-      &pack->sat_data[0].elv, &pack->sat_data[0].azimuth, &pack->sat_data[0].sig, &pack->sat_data[1].id,
-      &pack->sat_data[1].elv, &pack->sat_data[1].azimuth, &pack->sat_data[1].sig, &pack->sat_data[2].id,
-      &pack->sat_data[2].elv, &pack->sat_data[2].azimuth, &pack->sat_data[2].sig, &pack->sat_data[3].id,
-      &pack->sat_data[3].elv, &pack->sat_data[3].azimuth, &pack->sat_data[3].sig);
+  token_count = fields->count - 1;
+  if (!_nmea_field_header(s, fields, "GSV")) {
+    token_count = 0;
+  } else {
+    pack->system = _nmea_field_system(s, fields);
+  }
+
+  if (token_count > (NMEA_SATINPACK * 4 + 4)) {
+    token_count = NMEA_SATINPACK * 4 + 4;
+  }
+
+  if (token_count) {
+    _nmea_field_int(s, fields, 1, &pack->pack_count);
+    _nmea_field_int(s, fields, 2, &pack->pack_index);
+    _nmea_field_int(s, fields, 3, &pack->sat_count);
+
+    /* the signal ID of NMEA 4.10 follows the satellites */
+    if ((token_count > 3) && (((token_count - 3) % 4) == 1)) {
+      int signal_len;
+      const char *signal = nmea_parse_field(s, fields, token_count, &signal_len);
+
+      if (signal_len) {
+        pack->signal = nmea_atoi(signal, signal_len, 16);
+      }
+      token_count--;
+    }
+
+    for (sat_count = 0; (sat_count < NMEA_SATINPACK) && ((sat_count * 4 + 4) <= token_count); sat_count++) {
+      _nmea_field_int(s, fields, sat_count * 4 + 4, &pack->sat_data[sat_count].id);
+      _nmea_field_int(s, fields, sat_count * 4 + 5, &pack->sat_data[sat_count].elv);
+      _nmea_field_int(s, fields, sat_count * 4 + 6, &pack->sat_data[sat_count].azimuth);
+      _nmea_field_int(s, fields, sat_count * 4 + 7, &pack->sat_data[sat_count].sig);
+    }
+  }
 
   /* return if we have no sentences or sats */
   if ((pack->pack_count < 1) || (pack->pack_count > NMEA_NSATPACKS) || (pack->pack_index < 1)
-      || (pack->pack_index > pack->pack_count) || (pack->sat_count < 0) || (pack->sat_count > NMEA_MAXSAT)) {
+      || (pack->pack_index > pack->pack_count) || (pack->sat_count < 0)
+      || (pack->sat_count > (NMEA_NSATPACKS * NMEA_SATINPACK)) || (pack->signal < 0) || (pack->signal > 15)) {
 #if NMEA_ERROR
-    nmea_error("GPGSV parse error: inconsistent pack (count/index/satcount = %d/%d/%d)", pack->pack_count,
-        pack->pack_index, pack->sat_count);
+    nmea_error_record(PARSE_ERROR_PACK, GPGSV, 1,
+        ((pack->pack_count & 0xff) << 16) | ((pack->pack_index & 0xff) << 8) | (pack->sat_count & 0xff));
 #endif
     return 0;
   }
@@ -606,57 +1121,57 @@ int nmea_parse_GPGSV(const char *s, const int len, bool has_checksum, nmeaGPGSV
   /* validate all sat settings and count the number of sats in the sentence */
   for (sat_count = 0; sat_count < NMEA_SATINPACK; sat_count++) {
     if (pack->sat_data[sat_count].id != 0) {
-#if NMEA_VALIDATE
-      if ((pack->sat_data[sat_count].id < 0)) {
+      if (validation == VALIDATE_FULL) {
+        if ((pack->sat_data[sat_count].id < 0)) {
 #if NMEA_ERROR
-        nmea_error("GPGSV parse error: invalid sat %d id (%d)", sat_count + 1, pack->sat_data[sat_count].id);
+          nmea_error_record(PARSE_ERROR_SAT_ID, GPGSV, sat_count * 4 + 4, pack->sat_data[sat_count].id);
 #endif
-        return 0;
-      }
-      if ((pack->sat_data[sat_count].elv < -180) || (pack->sat_data[sat_count].elv > 180)) {
+          return 0;
+        }
+        if ((pack->sat_data[sat_count].elv < -180) || (pack->sat_data[sat_count].elv > 180)) {
 #if NMEA_ERROR
-        nmea_error("GPGSV parse error: invalid sat %d elevation (%d)", sat_count + 1, pack->sat_data[sat_count].elv);
+          nmea_error_record(PARSE_ERROR_SAT_ELEVATION, GPGSV, sat_count * 4 + 5, pack->sat_data[sat_count].elv);
 #endif
-        return 0;
-      }
-      if ((pack->sat_data[sat_count].azimuth < 0) || (pack->sat_data[sat_count].azimuth >= 360)) {
+          return 0;
+        }
+        if ((pack->sat_data[sat_count].azimuth < 0) || (pack->sat_data[sat_count].azimuth >= 360)) {
 #if NMEA_ERROR
-        nmea_error("GPGSV parse error: invalid sat %d azimuth (%d)", sat_count + 1, pack->sat_data[sat_count].azimuth);
+          nmea_error_record(PARSE_ERROR_SAT_AZIMUTH, GPGSV, sat_count * 4 + 6, pack->sat_data[sat_count].azimuth);
 #endif
-        return 0;
-      }
-      if ((pack->sat_data[sat_count].sig < 0) || (pack->sat_data[sat_count].sig > 99)) {
+          return 0;
+        }
+        if ((pack->sat_data[sat_count].sig < 0) || (pack->sat_data[sat_count].sig > 99)) {
 #if NMEA_ERROR
-        nmea_error("GPGSV parse error: invalid sat %d signal (%d)", sat_count + 1, pack->sat_data[sat_count].sig);
+          nmea_error_record(PARSE_ERROR_SAT_SNR, GPGSV, sat_count * 4 + 7, pack->sat_data[sat_count].sig);
 #endif
-        return 0;
+          return 0;
+        }
       }
-#endif
+      pack->sat_data[sat_count].system = pack->system ? pack->system : nmea_INFO_sat_system(pack->sat_data[sat_count].id);
+      pack->sat_data[sat_count].signal = pack->signal;
       sat_counted++;
     }
   }
 
   /* see that we have enough tokens */
   token_count_expected = (sat_counted * 4) + 3;
-  if ((token_count < token_count_expected) || (token_count > (NMEA_SATINPACK * 4 + 3))) {
+  if (token_count < token_count_expected) {
 #if NMEA_ERROR
-    nmea_error("GPGSV parse error: need %d tokens, got %d", token_count_expected, token_count);
+    nmea_error_record(PARSE_ERROR_TOKENS, GPGSV, 0, token_count);
 #endif
     return 0;
   }
 
-#if NMEA_VALIDATE
-  /* determine which fields are present and validate them */
+  /* determine which fields are present, the same at every validation level */
   if (pack->sat_count > 0) {
     nmea_INFO_set_present(&pack->present, SATINVIEW);
   }
-#endif
 
   return 1;
 }
 
 /**
- * Parse a GPRMC sentence from a string
+ * Parse a GPGSV sentence from a string
  *
  * @param s the string
  * @param len the length of the string
@@ -664,149 +1179,230 @@ int nmea_parse_GPGSV(const char *s, const int len, bool has_checksum, nmeaGPGSV
  * @param pack a pointer to the result structure
  * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
  */
-int nmea_parse_GPRMC(const char *s, const int len, bool has_checksum, nmeaGPRMC *pack) {
-  int token_count;
-  char time_buff[NMEA_TIMEPARSE_BUF];
-  int date;
-  size_t time_buff_len = 0;
+int nmea_parse_GPGSV(const char *s, const int len, bool has_checksum, nmeaGPGSV *pack) {
+  nmeaFIELDS fields;
 
   if (!has_checksum) {
     return 0;
   }
 
   NMEA_ASSERT(s);
+
+  nmea_parse_fields(s, len, &fields);
+  return nmea_parse_GPGSV_fields(s, len, &fields, VALIDATE_FULL, pack);
+}
+#endif
+
+#if NMEA_SENTENCE_RMC
+/** the nmeaINFO field of each RMC field, for VALIDATE_NONE (sig and fix follow from the status) */
+static const nmeaPRESENCE rmc_present[] = {
+    [1] = { UTCTIME, 0 },
+    [2] = { SIG | FIX, 0 },
+    [3] = { LAT, 4 },
+    [5] = { LON, 6 },
+    [7] = { SPEED, 0 },
+    [8] = { TRACK, 0 },
+    [9] = { UTCDATE, 0 },
+    [10] = { MAGVAR, 11 }
+};
+
+/**
+ * Parse a GPRMC sentence from a string that was split into fields
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param fields a pointer to the fields of the string (see nmea_parse_fields)
+ * @param validation the validation level (see nmeaVALIDATION)
+ * @param pack a pointer to the result structure
+ * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
+ */
+int nmea_parse_GPRMC_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPRMC *pack) {
+  int token_count;
+  int date;
+  uint32_t malformed = 0;
+
+  NMEA_ASSERT(s);
+  NMEA_ASSERT(fields);
   NMEA_ASSERT(pack);
 
+  /* the fields hold the offsets and lengths */
+  (void) len;
+
   /*
-   * Clear before parsing, to be able to detect absent fields
+   * Clear before parsing, full validation marks the absent fields
    */
-  time_buff[0] = '\0';
   date = -1;
-#if !NMEA_VALIDATE
-  memset(pack, 0, sizeof(nmeaGPRMC));
-#else
-  pack->present = 0;
-  pack->utc.year = -1;
-  pack->utc.mon = -1;
-  pack->utc.day = -1;
-  pack->utc.hour = -1;
-  pack->utc.min = -1;
-  pack->utc.sec = -1;
-  pack->utc.hsec = -1;
-  pack->status = 0;
-  pack->lat = NAN;
-  pack->ns = 0;
-  pack->lon = NAN;
-  pack->ew = 0;
-  pack->speed = NAN;
-  pack->track = NAN;
-  pack->magvar = NAN;
-  pack->magvar_ew = 0;
-  pack->mode = 0;
-#endif
+  if (validation != VALIDATE_FULL) {
+    memset(pack, 0, sizeof(nmeaGPRMC));
+  } else {
+    pack->present = 0;
+    pack->utc.year = -1;
+    pack->utc.mon = -1;
+    pack->utc.day = -1;
+    pack->utc.hour = -1;
+    pack->utc.min = -1;
+    pack->utc.sec = -1;
+    pack->utc.hsec = -1;
+    pack->status = 0;
+    pack->lat = NMEA_NONE;
+    pack->ns = 0;
+    pack->lon = NMEA_NONE;
+    pack->ew = 0;
+    pack->speed = NMEA_NONE;
+    pack->track = NMEA_NONE;
+    pack->magvar = NMEA_NONE;
+    pack->magvar_ew = 0;
+    pack->mode = 0;
+  }
 
   /* parse */
-  token_count = nmea_scanf(s, len, "$GPRMC,%s,%c,%f,%c,%f,%c,%f,%f,%d,%f,%c,%c*", &time_buff[0], &pack->status,
-      &pack->lat, &pack->ns, &pack->lon, &pack->ew, &pack->speed, &pack->track, &date,
-      &pack->magvar, &pack->magvar_ew, &pack->mode);
+  token_count = fields->count - 1;
+  if (token_count > 12) {
+    token_count = 12;
+  }
 
   /* see that we have enough tokens */
-  if ((token_count != 11) && (token_count != 12)) {
+  if ((token_count < 11) || !_nmea_field_header(s, fields, "RMC") || !_nmea_field_char(s, fields, 2, &pack->status)
+      || !_nmea_field_char(s, fields, 4, &pack->ns) || !_nmea_field_char(s, fields, 6, &pack->ew)
+      || !_nmea_field_char(s, fields, 11, &pack->magvar_ew) || !_nmea_field_char(s, fields, 12, &pack->mode)) {
 #if NMEA_ERROR
-    nmea_error("GPRMC parse error: need 11 or 12 tokens, got %d in %s", token_count, s);
+    nmea_error_record(PARSE_ERROR_TOKENS, GPRMC, 0, token_count);
 #endif
     return 0;
   }
 
-  /* determine which fields are present and validate them */
+  _nmea_field_coord(s, fields, 3, &pack->lat);
+  _nmea_field_coord(s, fields, 5, &pack->lon);
+  _nmea_field_speed(s, fields, 7, NMEA_KNOTS_MPH, &pack->speed);
+  _nmea_field_angle(s, fields, 8, &pack->track);
+  _nmea_field_int(s, fields, 9, &date);
+  _nmea_field_angle(s, fields, 10, &pack->magvar);
 
-  time_buff_len = strlen(&time_buff[0]);
-  if (time_buff_len) {
-    if (!_nmea_parse_time(&time_buff[0], time_buff_len, &pack->utc)) {
+  if (_nmea_field_present(fields, 1)
+      && !_nmea_parse_time(&s[fields->field[1].offset], fields->field[1].length, &pack->utc)) {
+    if (validation != VALIDATE_NONE) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_TIME_FORMAT, GPRMC, 1, fields->field[1].length);
+#endif
       return 0;
     }
 
-#if NMEA_VALIDATE
-    if (!validateTime(&pack->utc)) {
+    /* without validation a malformed time is absent */
+    malformed |= UTCTIME;
+  }
+
+  if (_nmea_field_present(fields, 9) && !_nmea_parse_date(date, &pack->utc)) {
+    if (validation != VALIDATE_NONE) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_DATE_FORMAT, GPRMC, 9, date);
+#endif
       return 0;
     }
 
-    nmea_INFO_set_present(&pack->present, UTCTIME);
-#endif
+    malformed |= UTCDATE;
+  }
+
+  /* the mode of NMEA 2.3, 'A' before */
+  if (token_count == 11) {
+    pack->mode = 'A';
   }
 
-  if (date != -1) {
-    if (!_nmea_parse_date(date, &pack->utc)) {
+  if (validation == VALIDATE_NONE) {
+    pack->present = _nmea_fields_present(fields, rmc_present, (int) (sizeof(rmc_present) / sizeof(rmc_present[0])))
+        & ~malformed;
+    return 1;
+  }
+
+  /* determine which fields are present and validate them */
+
+  if (_nmea_field_present(fields, 1)) {
+    if ((validation == VALIDATE_FULL) && !validateTime(&pack->utc)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_TIME, GPRMC, 1, (pack->utc.hour * 10000) + (pack->utc.min * 100) + pack->utc.sec);
+#endif
       return 0;
     }
+
+    nmea_INFO_set_present(&pack->present, UTCTIME);
   }
 
-#if NMEA_VALIDATE
+  /* without a status the fix is void */
+  nmea_INFO_set_present(&pack->present, SIG);
+  nmea_INFO_set_present(&pack->present, FIX);
   if (!pack->status) {
     pack->status = 'V';
-  } else {
+  } else if (validation == VALIDATE_FULL) {
     pack->status = toupper((unsigned char)pack->status);
     if (!((pack->status == 'A') || (pack->status == 'V'))) {
 #if NMEA_ERROR
-      nmea_error("GPRMC parse error: invalid status (%c)", pack->status);
+      nmea_error_record(PARSE_ERROR_STATUS, GPRMC, 2, pack->status);
 #endif
       return 0;
     }
   }
-  if (!isnan(pack->lat) && (pack->ns)) {
-    if (!validateNSEW(&pack->ns, true)) {
+  if (_nmea_field_present(fields, 3) && (pack->ns)) {
+    if ((validation == VALIDATE_FULL) && !validateNSEW(&pack->ns, true)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_DIRECTION, GPRMC, 4, pack->ns);
+#endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, LAT);
   }
-  if (!isnan(pack->lon) && (pack->ew)) {
-    if (!validateNSEW(&pack->ew, false)) {
+  if (_nmea_field_present(fields, 5) && (pack->ew)) {
+    if ((validation == VALIDATE_FULL) && !validateNSEW(&pack->ew, false)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_DIRECTION, GPRMC, 6, pack->ew);
+#endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, LON);
   }
-  if (!isnan(pack->speed)) {
+  if (_nmea_field_present(fields, 7)) {
     nmea_INFO_set_present(&pack->present, SPEED);
   }
-  if (!isnan(pack->track)) {
+  if (_nmea_field_present(fields, 8)) {
     nmea_INFO_set_present(&pack->present, TRACK);
   }
 
-  if (date != -1) {
-    if (!validateDate(&pack->utc)) {
+  if (_nmea_field_present(fields, 9)) {
+    if ((validation == VALIDATE_FULL) && !validateDate(&pack->utc)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_DATE, GPRMC, 9, date);
+#endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, UTCDATE);
   }
 
-  if (!isnan(pack->magvar) && (pack->magvar_ew)) {
-    if (!validateNSEW(&pack->magvar_ew, false)) {
+  if (_nmea_field_present(fields, 10) && (pack->magvar_ew)) {
+    if ((validation == VALIDATE_FULL) && !validateNSEW(&pack->magvar_ew, false)) {
+#if NMEA_ERROR
+      nmea_error_record(PARSE_ERROR_DIRECTION, GPRMC, 11, pack->magvar_ew);
+#endif
       return 0;
     }
 
     nmea_INFO_set_present(&pack->present, MAGVAR);
   }
-  if (token_count == 11) {
-    pack->mode = 'A';
-  } else {
-    if (!pack->mode) {
-      pack->mode = 'N';
-    } else {
-      if (!validateMode(&pack->mode)) {
-        return 0;
-      }
-    }
-  }
+  if (!pack->mode) {
+    pack->mode = 'N';
+  } else if ((validation == VALIDATE_FULL) && !validateMode(&pack->mode)) {
+#if NMEA_ERROR
+    nmea_error_record(PARSE_ERROR_MODE, GPRMC, 12, pack->mode);
 #endif
+    return 0;
+  }
 
   return 1;
 }
 
 /**
- * Parse a GPVTG sentence from a string
+ * Parse a GPRMC sentence from a string
  *
  * @param s the string
  * @param len the length of the string
@@ -814,103 +1410,198 @@ int nmea_parse_GPRMC(const char *s, const int len, bool has_checksum, nmeaGPRMC
  * @param pack a pointer to the result structure
  * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
  */
-int nmea_parse_GPVTG(const char *s, const int len, bool has_checksum, nmeaGPVTG *pack) {
-  int token_count;
+int nmea_parse_GPRMC(const char *s, const int len, bool has_checksum, nmeaGPRMC *pack) {
+  nmeaFIELDS fields;
 
   if (!has_checksum) {
     return 0;
   }
 
   NMEA_ASSERT(s);
+
+  nmea_parse_fields(s, len, &fields);
+  return nmea_parse_GPRMC_fields(s, len, &fields, VALIDATE_FULL, pack);
+}
+#endif
+
+#if NMEA_SENTENCE_VTG
+/** the nmeaINFO field of each VTG field, for VALIDATE_NONE */
+static const nmeaPRESENCE vtg_present[] = {
+    [1] = { TRACK, 0 },
+    [3] = { MTRACK, 0 },
+    [5] = { SPEED, 0 },
+    [7] = { SPEED, 0 }
+};
+
+/**
+ * Parse a GPVTG sentence from a string that was split into fields
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param fields a pointer to the fields of the string (see nmea_parse_fields)
+ * @param validation the validation level (see nmeaVALIDATION)
+ * @param pack a pointer to the result structure
+ * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
+ */
+int nmea_parse_GPVTG_fields(const char *s, const int len, const nmeaFIELDS *fields,
+    const enum nmeaVALIDATION validation, nmeaGPVTG *pack) {
+  int token_count;
+
+  NMEA_ASSERT(s);
+  NMEA_ASSERT(fields);
   NMEA_ASSERT(pack);
 
+  /* the fields hold the offsets and lengths */
+  (void) len;
+
   /*
-   * Clear before parsing, to be able to detect absent fields
+   * Clear before parsing, full validation marks the absent fields
    */
-#if !NMEA_VALIDATE
-  memset(pack, 0, sizeof(nmeaGPVTG));
-#else
-  pack->present = 0;
-  pack->track = NAN;
-  pack->track_t = 0;
-  pack->mtrack = NAN;
-  pack->mtrack_m = 0;
-  pack->spn = NAN;
-  pack->spn_n = 0;
-  pack->spk = NAN;
-  pack->spk_k = 0;
-#endif
+  if (validation != VALIDATE_FULL) {
+    memset(pack, 0, sizeof(nmeaGPVTG));
+  } else {
+    pack->present = 0;
+    pack->track = NMEA_NONE;
+    pack->track_t = 0;
+    pack->mtrack = NMEA_NONE;
+    pack->mtrack_m = 0;
+    pack->spn = NMEA_NONE;
+    pack->spn_n = 0;
+    pack->spk = NMEA_NONE;
+    pack->spk_k = 0;
+  }
 
   /* parse */
-  token_count = nmea_scanf(s, len, "$GPVTG,%f,%c,%f,%c,%f,%c,%f,%c*", &pack->track, &pack->track_t, &pack->mtrack,
-      &pack->mtrack_m, &pack->spn, &pack->spn_n, &pack->spk, &pack->spk_k);
+  token_count = fields->count - 1;
 
   /* see that we have enough tokens */
-  if (token_count != 8) {
+  if ((token_count < 8) || !_nmea_field_header(s, fields, "VTG") || !_nmea_field_char(s, fields, 2, &pack->track_t)
+      || !_nmea_field_char(s, fields, 4, &pack->mtrack_m) || !_nmea_field_char(s, fields, 6, &pack->spn_n)
+      || !_nmea_field_char(s, fields, 8, &pack->spk_k)) {
 #if NMEA_ERROR
-    nmea_error("GPVTG parse error: need 8 tokens, got %d in %s", token_count, s);
+    nmea_error_record(PARSE_ERROR_TOKENS, GPVTG, 0, token_count);
 #endif
     return 0;
   }
 
-#if NMEA_VALIDATE
+  _nmea_field_angle(s, fields, 1, &pack->track);
+  _nmea_field_angle(s, fields, 3, &pack->mtrack);
+  _nmea_field_speed(s, fields, 5, NMEA_KNOTS_MPH, &pack->spn);
+  _nmea_field_speed(s, fields, 7, NMEA_KPH_MPH, &pack->spk);
+
+  if (validation == VALIDATE_NONE) {
+    pack->present = _nmea_fields_present(fields, vtg_present, (int) (sizeof(vtg_present) / sizeof(vtg_present[0])));
+    if (!_nmea_field_present(fields, 5) && _nmea_field_present(fields, 7)) {
+#if NMEA_FIXED_POINT
+      pack->spn = pack->spk;
+#else
+      pack->spn = pack->spk / NMEA_TUD_KNOTS;
+#endif
+    } else if (_nmea_field_present(fields, 5) && !_nmea_field_present(fields, 7)) {
+#if NMEA_FIXED_POINT
+      pack->spk = pack->spn;
+#else
+      pack->spk = pack->spn * NMEA_TUD_KNOTS;
+#endif
+    }
+    return 1;
+  }
+
   /* determine which fields are present and validate them */
 
-  if (!isnan(pack->track) && (pack->track_t)) {
-    pack->track_t = toupper((unsigned char)pack->track_t);
-    if (pack->track_t != 'T') {
+  if (_nmea_field_present(fields, 1) && (pack->track_t)) {
+    if (validation == VALIDATE_FULL) {
+      pack->track_t = toupper((unsigned char)pack->track_t);
+      if (pack->track_t != 'T') {
 #if NMEA_ERROR
-      nmea_error("GPVTG parse error: invalid track unit, got %c, expected T", pack->track_t);
+        nmea_error_record(PARSE_ERROR_UNIT, GPVTG, 2, pack->track_t);
 #endif
-      return 0;
+        return 0;
+      }
     }
 
     nmea_INFO_set_present(&pack->present, TRACK);
   }
-  if (!isnan(pack->mtrack) && (pack->mtrack_m)) {
-    pack->mtrack_m = toupper((unsigned char)pack->mtrack_m);
-    if (pack->mtrack_m != 'M') {
+  if (_nmea_field_present(fields, 3) && (pack->mtrack_m)) {
+    if (validation == VALIDATE_FULL) {
+      pack->mtrack_m = toupper((unsigned char)pack->mtrack_m);
+      if (pack->mtrack_m != 'M') {
 #if NMEA_ERROR
-      nmea_error("GPVTG parse error: invalid mtrack unit, got %c, expected M", pack->mtrack_m);
+        nmea_error_record(PARSE_ERROR_UNIT, GPVTG, 4, pack->mtrack_m);
 #endif
-      return 0;
+        return 0;
+      }
     }
 
     nmea_INFO_set_present(&pack->present, MTRACK);
   }
-  if (!isnan(pack->spn) && (pack->spn_n)) {
-    pack->spn_n = toupper((unsigned char)pack->spn_n);
-    if (pack->spn_n != 'N') {
+  if (_nmea_field_present(fields, 5) && (pack->spn_n)) {
+    if (validation == VALIDATE_FULL) {
+      pack->spn_n = toupper((unsigned char)pack->spn_n);
+      if (pack->spn_n != 'N') {
 #if NMEA_ERROR
-      nmea_error("GPVTG parse error: invalid knots speed unit, got %c, expected N", pack->spn_n);
+        nmea_error_record(PARSE_ERROR_UNIT, GPVTG, 6, pack->spn_n);
 #endif
-      return 0;
+        return 0;
+      }
     }
 
     nmea_INFO_set_present(&pack->present, SPEED);
 
-    if (isnan(pack->spk)) {
+    if (!_nmea_field_present(fields, 7)) {
+#if NMEA_FIXED_POINT
+      pack->spk = pack->spn;
+#else
       pack->spk = pack->spn * NMEA_TUD_KNOTS;
+#endif
       pack->spk_k = 'K';
     }
   }
-  if (!isnan(pack->spk) && (pack->spk_k)) {
-    pack->spk_k = toupper((unsigned char)pack->spk_k);
-    if (pack->spk_k != 'K') {
+  if (_nmea_field_present(fields, 7) && (pack->spk_k)) {
+    if (validation == VALIDATE_FULL) {
+      pack->spk_k = toupper((unsigned char)pack->spk_k);
+      if (pack->spk_k != 'K') {
 #if NMEA_ERROR
-      nmea_error("GPVTG parse error: invalid kph speed unit, got %c, expected K", pack->spk_k);
+        nmea_error_record(PARSE_ERROR_UNIT, GPVTG, 8, pack->spk_k);
 #endif
-      return 0;
+        return 0;
+      }
     }
 
     nmea_INFO_set_present(&pack->present, SPEED);
 
-    if (isnan(pack->spn)) {
+    if (!_nmea_field_present(fields, 5)) {
+#if NMEA_FIXED_POINT
+      pack->spn = pack->spk;
+#else
       pack->spn = pack->spk / NMEA_TUD_KNOTS;
+#endif
       pack->spn_n = 'N';
     }
   }
-#endif
 
   return 1;
 }
+
+/**
+ * Parse a GPVTG sentence from a string
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param has_checksum true when the string contains a checksum
+ * @param pack a pointer to the result structure
+ * @return 1 (true) - if parsed successfully or 0 (false) otherwise.
+ */
+int nmea_parse_GPVTG(const char *s, const int len, bool has_checksum, nmeaGPVTG *pack) {
+  nmeaFIELDS fields;
+
+  if (!has_checksum) {
+    return 0;
+  }
+
+  NMEA_ASSERT(s);
+
+  nmea_parse_fields(s, len, &fields);
+  return nmea_parse_GPVTG_fields(s, len, &fields, VALIDATE_FULL, pack);
+}
+#endif
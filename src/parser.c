@@ -18,57 +18,221 @@
 #include <nmea/parser.h>
 
 #include <nmea/parse.h>
+#include <nmea/ring.h>
 #include <nmea/sentence.h>
 #include <nmea/conversions.h>
-#include <nmea/tok.h>
+#include <nmea/scan.h>
 
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include <ctype.h>
+#include <stdint.h>
 
-#define first_eol_char  ('\r')
-#define second_eol_char ('\n')
+/**
+ * Character classes of the frame parser
+ */
+typedef enum _sentence_char_class {
+  CHAR_PLAIN,   /**< allowed in a sentence, no special meaning */
+  CHAR_HEX,     /**< allowed in a sentence, valid checksum digit */
+  CHAR_START,   /**< '$' */
+  CHAR_STAR,    /**< '*' */
+  CHAR_CR,      /**< '\r' */
+  CHAR_LF,      /**< '\n' */
+  CHAR_INVALID, /**< not allowed in a sentence (see isInvalidNMEACharacter) */
+  CHAR_CLASSES
+} sentence_char_class;
+
+/*
+ * Compile-time generation of the character class table. Each entry holds the
+ * class in its low nibble and the value of the character as a hex digit in its
+ * high nibble.
+ */
+#define NMEA_CHAR_IS_HEX(c) \
+  ((((c) >= '0') && ((c) <= '9')) || (((c) >= 'A') && ((c) <= 'F')) || (((c) >= 'a') && ((c) <= 'f')))
+#define NMEA_CHAR_HEX(c) \
+  ((((c) >= '0') && ((c) <= '9')) ? ((c) - '0') : \
+   (((c) >= 'A') && ((c) <= 'F')) ? ((c) - 'A' + 10) : \
+   (((c) >= 'a') && ((c) <= 'f')) ? ((c) - 'a' + 10) : 0)
+#define NMEA_CHAR_CLASS(c) \
+  (((c) == '$') ? CHAR_START : \
+   ((c) == '*') ? CHAR_STAR : \
+   ((c) == '\r') ? CHAR_CR : \
+   ((c) == '\n') ? CHAR_LF : \
+   (((c) < 32) || ((c) > 126) || ((c) == '!') || ((c) == '\\') || ((c) == '^') || ((c) == '~')) ? CHAR_INVALID : \
+   NMEA_CHAR_IS_HEX(c) ? CHAR_HEX : CHAR_PLAIN)
+#define NMEA_CHAR(c)    ((uint8_t) (NMEA_CHAR_CLASS(c) | (NMEA_CHAR_HEX(c) << 4)))
+#define NMEA_CHAR4(c)   NMEA_CHAR(c), NMEA_CHAR((c) + 1), NMEA_CHAR((c) + 2), NMEA_CHAR((c) + 3)
+#define NMEA_CHAR16(c)  NMEA_CHAR4(c), NMEA_CHAR4((c) + 4), NMEA_CHAR4((c) + 8), NMEA_CHAR4((c) + 12)
+#define NMEA_CHAR64(c)  NMEA_CHAR16(c), NMEA_CHAR16((c) + 16), NMEA_CHAR16((c) + 32), NMEA_CHAR16((c) + 48)
+
+/** the character class table, indexed by the (unsigned) character */
+static const uint8_t charClasses[256] = {
+    NMEA_CHAR64(0),
+    NMEA_CHAR64(64),
+    NMEA_CHAR64(128),
+    NMEA_CHAR64(192)
+};
+
+/**
+ * Actions of the frame parser, performed on a transition
+ */
+typedef enum _sentence_action {
+  ACTION_SKIP,        /**< ignore the character */
+  ACTION_START,       /**< start a new sentence */
+  ACTION_STORE,       /**< store the character */
+  ACTION_STORE_XOR,   /**< store the character and add it to the checksum */
+  ACTION_HEADER,      /**< store the character and add it to the checksum, filter the sentence after the header */
+  ACTION_CHECKSUM_HI, /**< store the character as the first checksum digit */
+  ACTION_CHECKSUM_LO, /**< store the character as the second checksum digit */
+  ACTION_DONE,        /**< store the character, the sentence is complete */
+  ACTION_RESET        /**< discard the sentence */
+} sentence_action;
+
+#define T(action, state)  ((uint8_t) (((action) << 4) | (state)))
+#define RESET             T(ACTION_RESET, SKIP_UNTIL_START)
+#define START             T(ACTION_START, READ_HEADER)
+
+/**
+ * The transition table, indexed by state and character class. Each entry holds
+ * the next state in its low nibble and the action in its high nibble.
+ */
+static const uint8_t transitions[SENTENCE_PARSER_STATES][CHAR_CLASSES] = {
+    [SKIP_UNTIL_START] = {
+        [CHAR_PLAIN]   = T(ACTION_SKIP, SKIP_UNTIL_START),
+        [CHAR_HEX]     = T(ACTION_SKIP, SKIP_UNTIL_START),
+        [CHAR_START]   = START,
+        [CHAR_STAR]    = T(ACTION_SKIP, SKIP_UNTIL_START),
+        [CHAR_CR]      = T(ACTION_SKIP, SKIP_UNTIL_START),
+        [CHAR_LF]      = T(ACTION_SKIP, SKIP_UNTIL_START),
+        [CHAR_INVALID] = T(ACTION_SKIP, SKIP_UNTIL_START)
+    },
+    [READ_HEADER] = {
+        [CHAR_PLAIN]   = T(ACTION_HEADER, READ_HEADER),
+        [CHAR_HEX]     = T(ACTION_HEADER, READ_HEADER),
+        [CHAR_START]   = START,
+        [CHAR_STAR]    = T(ACTION_STORE, READ_CHECKSUM),
+        [CHAR_CR]      = T(ACTION_STORE, READ_EOL_LF),
+        [CHAR_LF]      = RESET,
+        [CHAR_INVALID] = RESET
+    },
+    [READ_SENTENCE] = {
+        [CHAR_PLAIN]   = T(ACTION_STORE_XOR, READ_SENTENCE),
+        [CHAR_HEX]     = T(ACTION_STORE_XOR, READ_SENTENCE),
+        [CHAR_START]   = START,
+        [CHAR_STAR]    = T(ACTION_STORE, READ_CHECKSUM),
+        [CHAR_CR]      = T(ACTION_STORE, READ_EOL_LF),
+        [CHAR_LF]      = RESET,
+        [CHAR_INVALID] = RESET
+    },
+    [READ_CHECKSUM] = {
+        [CHAR_PLAIN]   = RESET,
+        [CHAR_HEX]     = T(ACTION_CHECKSUM_HI, READ_CHECKSUM_LO),
+        [CHAR_START]   = START,
+        [CHAR_STAR]    = RESET,
+        [CHAR_CR]      = RESET,
+        [CHAR_LF]      = RESET,
+        [CHAR_INVALID] = RESET
+    },
+    [READ_CHECKSUM_LO] = {
+        [CHAR_PLAIN]   = RESET,
+        [CHAR_HEX]     = T(ACTION_CHECKSUM_LO, READ_EOL),
+        [CHAR_START]   = START,
+        [CHAR_STAR]    = RESET,
+        [CHAR_CR]      = RESET,
+        [CHAR_LF]      = RESET,
+        [CHAR_INVALID] = RESET
+    },
+    [READ_EOL] = {
+        [CHAR_PLAIN]   = RESET,
+        [CHAR_HEX]     = RESET,
+        [CHAR_START]   = START,
+        [CHAR_STAR]    = RESET,
+        [CHAR_CR]      = T(ACTION_STORE, READ_EOL_LF),
+        [CHAR_LF]      = RESET,
+        [CHAR_INVALID] = RESET
+    },
+    [READ_EOL_LF] = {
+        [CHAR_PLAIN]   = RESET,
+        [CHAR_HEX]     = RESET,
+        [CHAR_START]   = START,
+        [CHAR_STAR]    = RESET,
+        [CHAR_CR]      = RESET,
+        [CHAR_LF]      = T(ACTION_DONE, SKIP_UNTIL_START),
+        [CHAR_INVALID] = RESET
+    }
+};
+
+#undef START
+#undef RESET
+#undef T
+
+#if NMEA_PARSER_STATS
+#define NMEA_PARSER_COUNT(parser, counter, n) ((parser)->stats.counter += (n))
+#else
+#define NMEA_PARSER_COUNT(parser, counter, n) ((void) 0)
+#endif
+
+#if NMEA_PARSER_TRACE
+#define NMEA_PARSER_STAMP(parser, stamp) ((parser)->trace.stamp = NMEA_TRACE_CLOCK())
+#define NMEA_PARSER_RECORD(parser, slot) nmea_parser_record(parser, slot)
+#else
+#define NMEA_PARSER_STAMP(parser, stamp) ((void) 0)
+#define NMEA_PARSER_RECORD(parser, slot) ((void) 0)
+#endif
+
+#if NMEA_PARSER_TRACE
+/**
+ * Add a latency to a histogram
+ *
+ * @param latency a pointer to the histogram
+ * @param ticks the latency
+ */
+static void nmea_latency_add(nmeaLATENCY *latency, const uint32_t ticks) {
+  if (!latency->count || (ticks < latency->min)) {
+    latency->min = ticks;
+  }
+  if (ticks > latency->max) {
+    latency->max = ticks;
+  }
+  latency->count++;
+  latency->sum += ticks;
+  latency->buckets[ticks ? (31 - __builtin_clz(ticks)) : 0]++;
+}
+
+/**
+ * Record the latencies of a sentence that was decoded and merged
+ *
+ * @param parser a pointer to the parser
+ * @param slot the slot of the sentence type (see nmea_parser_callback_slot)
+ */
+static void nmea_parser_record(nmeaPARSER *parser, const int slot) {
+  uint32_t now = NMEA_TRACE_CLOCK();
+
+  nmea_latency_add(&parser->trace.receive[slot], parser->trace.eol - parser->trace.start);
+  nmea_latency_add(&parser->trace.process[slot], now - parser->trace.eol);
+  nmea_latency_add(&parser->trace.total[slot], now - parser->trace.start);
+
+#if NMEA_TRACE_BOUND
+  if ((now - parser->trace.eol) > NMEA_TRACE_BOUND) {
+    parser->trace.exceeded[slot]++;
+  }
+#endif
+}
+#endif
 
 static void reset_sentence_parser(nmeaPARSER * parser, sentence_parser_state new_state) {
   NMEA_ASSERT(parser);
   memset(&parser->sentence_parser, 0, sizeof(parser->sentence_parser));
   parser->buffer.buffer[0] = '\0';
   parser->buffer.length = 0;
+  parser->fields.count = 0;
   parser->sentence_parser.has_checksum = false;
   parser->sentence_parser.state = new_state;
 }
 
-static inline bool isHexChar(char c) {
-  switch (tolower((unsigned char)c)) {
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9':
-    case 'a':
-    case 'b':
-    case 'c':
-    case 'd':
-    case 'e':
-    case 'f':
-      return true;
-
-    default:
-      break;
-  }
-
-  return false;
-}
-
 /**
  * Initialise the parser.
- * Allocates a buffer.
+ * Allocates a buffer and removes all callbacks.
  *
  * @param parser a pointer to the parser
  * @return true (1) - success or false (0) - fail
@@ -76,173 +240,524 @@ static inline bool isHexChar(char c) {
 int nmea_parser_init(nmeaPARSER *parser) {
   NMEA_ASSERT(parser);
   memset(&parser->sentence, 0, sizeof(parser->sentence));
+  memset(&parser->callbacks, 0, sizeof(parser->callbacks));
+#if NMEA_SENTENCE_GSV
+  memset(&parser->gsv_cycle, 0, sizeof(parser->gsv_cycle));
+#endif
+  parser->validation = VALIDATE_FULL;
+  parser->filter.types = 0;
+  parser->filter.talkers = 0;
+  nmea_parser_reset_stats(parser);
+#if NMEA_PARSER_TRACE
+  nmea_parser_reset_trace(parser);
+#endif
   reset_sentence_parser(parser, SKIP_UNTIL_START);
   return 1;
 }
 
-static bool nmea_parse_sentence_character(nmeaPARSER *parser, const char * c) {
+/**
+ * Set the validation level of the sentences (see nmeaVALIDATION), the
+ * parser validates fully after nmea_parser_init. Structural validation skips
+ * the checks of the field values, no validation also those of their formats:
+ * every field that is not empty is merged. For receivers that are trusted to
+ * send well-formed sentences (like over a wire, with the checksum protecting
+ * against transmission errors). Set it after nmea_parser_init (or
+ * nmea_epoch_init), before parsing.
+ *
+ * @param parser a pointer to the parser
+ * @param validation the validation level
+ */
+void nmea_parser_set_validation(nmeaPARSER *parser, const enum nmeaVALIDATION validation) {
   NMEA_ASSERT(parser);
+  NMEA_ASSERT((validation >= VALIDATE_NONE) && (validation <= VALIDATE_FULL));
+  parser->validation = validation;
+}
 
-  /* always reset when we encounter a start-of-sentence character */
-  if (*c == '$') {
-    reset_sentence_parser(parser, READ_SENTENCE);
-    parser->buffer.buffer[parser->buffer.length++] = *c;
-    return false;
-  }
+/**
+ * Set the sentences that the parser accepts, by sentence type and talker. The
+ * filter looks at the header of a sentence as soon as it has arrived, the
+ * rest of a sentence that is not accepted is skipped up to the next '$'
+ * without being stored or checksummed (counted as filtered in the stats).
+ * The parser accepts all sentences after nmea_parser_init.
+ *
+ * @param parser a pointer to the parser
+ * @param types the sentence types (see nmeaPACKTYPE) to accept, 0 to accept all sentences (no filter)
+ * @param talkers the talkers to accept (see NMEA_TALKER_BIT), 0 to accept all supported talkers
+ */
+void nmea_parser_set_filter(nmeaPARSER *parser, const int types, const uint32_t talkers) {
+  NMEA_ASSERT(parser);
+  parser->filter.types = types;
+  parser->filter.talkers = talkers;
+}
 
-  /* just return when we haven't encountered a start-of-sentence character yet */
-  if (parser->sentence_parser.state == SKIP_UNTIL_START) {
-    return false;
+/**
+ * Filter a sentence when its header has been stored, continuing to read an
+ * accepted sentence and skipping the rest of one that is not.
+ *
+ * @param parser a pointer to the parser
+ */
+static inline void nmea_parser_filter(nmeaPARSER *parser) {
+  const char *header = &parser->buffer.buffer[1];
+
+  if (!parser->filter.types
+      || ((parser->filter.types & (int) nmea_parse_get_sentence_type(header, NMEA_HEADER_SIZE - 1))
+          && (!parser->filter.talkers
+              || (parser->filter.talkers & NMEA_TALKER_BIT(nmea_parse_get_talker(header, NMEA_HEADER_SIZE - 1)))))) {
+    parser->sentence_parser.state = READ_SENTENCE;
+    return;
   }
 
-  /* this character belongs to the sentence */
+  NMEA_PARSER_COUNT(parser, filtered, 1);
+  reset_sentence_parser(parser, SKIP_UNTIL_START);
+}
 
-  /* check whether the sentence still fits in the buffer */
+/**
+ * Store a character of a sentence in the parser buffer.
+ * Discards the sentence when it does not fit in the buffer.
+ *
+ * @param parser a pointer to the parser
+ * @param c the character
+ * @return true when the character was stored
+ */
+static inline bool store_sentence_character(nmeaPARSER *parser, const char c) {
   if (parser->buffer.length >= SENTENCE_SIZE) {
+    NMEA_PARSER_COUNT(parser, overflow, 1);
     reset_sentence_parser(parser, SKIP_UNTIL_START);
     return false;
   }
 
-  parser->buffer.buffer[parser->buffer.length++] = *c;
+  parser->buffer.buffer[parser->buffer.length++] = c;
+  return true;
+}
 
-  switch (parser->sentence_parser.state) {
-    case READ_SENTENCE:
-      if (*c == '*') {
-        parser->sentence_parser.state = READ_CHECKSUM;
-        parser->sentence_parser.sentence_checksum_chars_count = 0;
-      } else if (*c == first_eol_char) {
-        parser->sentence_parser.state = READ_EOL;
-        parser->sentence_parser.sentence_eol_chars_count = 1;
-      } else if (isInvalidNMEACharacter(c)) {
-        reset_sentence_parser(parser, SKIP_UNTIL_START);
-      } else {
-        parser->sentence_parser.calculated_checksum ^= (int) *c;
+/**
+ * Feed a character to the frame parser.
+ * Costs a lookup in the character class table and one in the transition
+ * table, followed by the action of the transition.
+ *
+ * @param parser a pointer to the parser
+ * @param c a pointer to the character
+ * @return true when the character completed a sentence with a valid (or without a) checksum
+ */
+static bool nmea_parse_sentence_character(nmeaPARSER *parser, const char * c) {
+  uint8_t charClass;
+  uint8_t transition;
+
+  NMEA_ASSERT(parser);
+
+  charClass = charClasses[(unsigned char) *c];
+  transition = transitions[parser->sentence_parser.state][charClass & 0x0f];
+
+  switch ((sentence_action) (transition >> 4)) {
+    case ACTION_SKIP:
+      NMEA_PARSER_COUNT(parser, skipped, 1);
+      break;
+
+    case ACTION_START:
+      if (parser->sentence_parser.state != SKIP_UNTIL_START) {
+        NMEA_PARSER_COUNT(parser, interrupted, 1);
       }
+      NMEA_PARSER_STAMP(parser, start);
+      reset_sentence_parser(parser, (sentence_parser_state) (transition & 0x0f));
+      parser->buffer.buffer[parser->buffer.length++] = *c;
       break;
 
-    case READ_CHECKSUM:
-      if (!isHexChar(*c)) {
-        reset_sentence_parser(parser, SKIP_UNTIL_START);
-      } else {
-        switch (parser->sentence_parser.sentence_checksum_chars_count) {
-          case 0:
-            parser->sentence_parser.sentence_checksum_chars[0] = *c;
-            parser->sentence_parser.sentence_checksum_chars[1] = 0;
-            parser->sentence_parser.sentence_checksum_chars_count = 1;
-            break;
-
-          case 1:
-            parser->sentence_parser.sentence_checksum_chars[1] = *c;
-            parser->sentence_parser.sentence_checksum_chars_count = 2;
-            parser->sentence_parser.sentence_checksum = nmea_atoi(parser->sentence_parser.sentence_checksum_chars, 2, 16);
-            parser->sentence_parser.has_checksum = true;
-            parser->sentence_parser.state = READ_EOL;
-            break;
-
-          default:
-            reset_sentence_parser(parser, SKIP_UNTIL_START);
-            break;
-          }
+    case ACTION_STORE_XOR:
+      /* the state does not change */
+      if (store_sentence_character(parser, *c)) {
+        parser->sentence_parser.calculated_checksum ^= (int) *c;
       }
       break;
 
+    case ACTION_HEADER:
+      /* the buffer holds at most NMEA_HEADER_SIZE characters */
+      parser->buffer.buffer[parser->buffer.length++] = *c;
+      parser->sentence_parser.calculated_checksum ^= (int) *c;
+      if (parser->buffer.length == NMEA_HEADER_SIZE) {
+        nmea_parser_filter(parser);
+      }
+      break;
 
-    case READ_EOL:
-      switch (parser->sentence_parser.sentence_eol_chars_count) {
-        case 0:
-          if (*c != first_eol_char) {
-            reset_sentence_parser(parser, SKIP_UNTIL_START);
-          } else {
-            parser->sentence_parser.sentence_eol_chars_count = 1;
-          }
-          break;
+    case ACTION_STORE:
+      if (store_sentence_character(parser, *c)) {
+        parser->sentence_parser.state = (sentence_parser_state) (transition & 0x0f);
+      }
+      break;
 
-        case 1:
-          if (*c != second_eol_char) {
-            reset_sentence_parser(parser, SKIP_UNTIL_START);
-          } else {
-            parser->sentence_parser.state = SKIP_UNTIL_START;
-            return (!parser->sentence_parser.sentence_checksum_chars_count
-                || (parser->sentence_parser.sentence_checksum_chars_count
-                    && (parser->sentence_parser.sentence_checksum == parser->sentence_parser.calculated_checksum)));
-          }
-          break;
+    case ACTION_CHECKSUM_HI:
+      if (store_sentence_character(parser, *c)) {
+        parser->sentence_parser.sentence_checksum = (charClass >> 4) << 4;
+        parser->sentence_parser.state = (sentence_parser_state) (transition & 0x0f);
+      }
+      break;
 
-        default:
-          reset_sentence_parser(parser, SKIP_UNTIL_START);
-          break;
+    case ACTION_CHECKSUM_LO:
+      if (store_sentence_character(parser, *c)) {
+        parser->sentence_parser.sentence_checksum |= (charClass >> 4);
+        parser->sentence_parser.has_checksum = true;
+        parser->sentence_parser.state = (sentence_parser_state) (transition & 0x0f);
       }
       break;
 
-      /* can't occur, but keep compiler happy */
-      case SKIP_UNTIL_START:
-      default:
-        break;
+    case ACTION_DONE:
+      if (store_sentence_character(parser, *c)) {
+        parser->sentence_parser.state = (sentence_parser_state) (transition & 0x0f);
+        if (parser->sentence_parser.has_checksum
+            && (parser->sentence_parser.sentence_checksum != parser->sentence_parser.calculated_checksum)) {
+          NMEA_PARSER_COUNT(parser, checksum, 1);
+          return false;
+        }
+
+        NMEA_PARSER_STAMP(parser, eol);
+        NMEA_PARSER_COUNT(parser, framed, 1);
+#if NMEA_PARSER_STATS
+        if (parser->buffer.length > parser->stats.max_length) {
+          parser->stats.max_length = parser->buffer.length;
+        }
+#endif
+        return true;
+      }
+      break;
 
+    case ACTION_RESET:
+    default:
+      NMEA_PARSER_COUNT(parser, invalid, 1);
+      reset_sentence_parser(parser, SKIP_UNTIL_START);
+      break;
   }
 
   return false;
 }
 
+#if NMEA_BULK_SCAN
 /**
- * Parse a string and store the results in the nmeaINFO structure
+ * Consume a run of characters that the frame parser would handle without
+ * looking at them individually: everything up to the next '$' while waiting
+ * for the start of a sentence, or the plain sentence characters (see
+ * nmea_scan_sentence) while reading the header or the rest of a sentence. The
+ * header is filtered once it is complete. The parser ends up in exactly
+ * the state it would have been in after feeding the run character by
+ * character.
  *
  * @param parser a pointer to the parser
  * @param s the string
  * @param len the length of the string
- * @param info a pointer to the nmeaINFO structure
+ * @return the number of characters that were consumed
+ */
+static int nmea_parse_sentence_span(nmeaPARSER *parser, const char * s, int len) {
+  const char * start;
+  size_t room;
+  size_t span;
+
+  NMEA_ASSERT(parser);
+
+  switch (parser->sentence_parser.state) {
+    case SKIP_UNTIL_START:
+      start = memchr(s, '$', len);
+      span = (start ? (size_t) (start - s) : (size_t) len);
+      NMEA_PARSER_COUNT(parser, skipped, span);
+      return (int) span;
+
+    case READ_HEADER:
+      room = NMEA_HEADER_SIZE - parser->buffer.length;
+      span = nmea_scan_sentence(s, ((size_t) len < room) ? (size_t) len : room,
+          &parser->sentence_parser.calculated_checksum);
+      memcpy(&parser->buffer.buffer[parser->buffer.length], s, span);
+      parser->buffer.length += span;
+      if (parser->buffer.length == NMEA_HEADER_SIZE) {
+        nmea_parser_filter(parser);
+      }
+      return (int) span;
+
+    case READ_SENTENCE:
+      room = SENTENCE_SIZE - parser->buffer.length;
+      span = nmea_scan_sentence(s, ((size_t) len < room) ? (size_t) len : room,
+          &parser->sentence_parser.calculated_checksum);
+      memcpy(&parser->buffer.buffer[parser->buffer.length], s, span);
+      parser->buffer.length += span;
+      return (int) span;
+
+    default:
+      break;
+  }
+
+  return 0;
+}
+#endif
+
+/**
+ * Determine the callback slot of a sentence type
+ *
+ * @param type the sentence type
+ * @return the slot, -1 when callbacks can not be registered for the type
+ */
+static inline int nmea_parser_callback_slot(const enum nmeaPACKTYPE type) {
+  switch (type) {
+    case GPGGA:
+      return 0;
+
+    case GPGSA:
+      return 1;
+
+    case GPGSV:
+      return 2;
+
+    case GPRMC:
+      return 3;
+
+    case GPVTG:
+      return 4;
+
+    case GPNON:
+    default:
+      return -1;
+  }
+}
+
+/**
+ * Register a callback for a sentence type, replacing the callback that was
+ * registered for it before. Register callbacks after nmea_parser_init.
+ *
+ * @param parser a pointer to the parser
+ * @param type the sentence type
+ * @param function the callback, NULL to remove the callback
+ * @param arg the argument for the callback
+ * @return true when the callback was registered, false for an unsupported type
+ */
+bool nmea_parser_set_callback(nmeaPARSER *parser, const enum nmeaPACKTYPE type, nmeaCALLBACK function, void *arg) {
+  int slot = nmea_parser_callback_slot(type);
+
+  NMEA_ASSERT(parser);
+
+  if (slot < 0) {
+    return false;
+  }
+
+  parser->callbacks[slot].function = function;
+  parser->callbacks[slot].arg = arg;
+  return true;
+}
+
+/**
+ * Initialise the argument of nmea_parser_info_callback
+ *
+ * @param merge a pointer to the argument
+ * @param info a pointer to the nmeaINFO structure into which the sentences are merged
+ */
+void nmea_parser_info_merge_init(nmeaINFOMERGE *merge, nmeaINFO *info) {
+  NMEA_ASSERT(merge);
+  NMEA_ASSERT(info);
+  memset(merge, 0, sizeof(*merge));
+  merge->info = info;
+}
+
+/**
+ * A sentence callback that merges the sentence into the nmeaINFO structure of
+ * its argument, like nmea_parse does with its info argument: the satellites
+ * of a GSV cycle are merged at once when the cycle is complete. Register it
+ * for the sentence types of which the information is needed and call
+ * nmea_parse without an nmeaINFO structure to merge only those.
+ *
+ * @param type the sentence type
+ * @param pack a pointer to the decoded sentence
+ * @param s the raw sentence (unused)
+ * @param len the length of the raw sentence (unused)
+ * @param arg a pointer to the nmeaINFOMERGE structure (see nmea_parser_info_merge_init)
+ */
+void nmea_parser_info_callback(const enum nmeaPACKTYPE type, const void *pack, const char *s, const int len, void *arg) {
+  nmeaINFOMERGE *merge = (nmeaINFOMERGE *) arg;
+  nmeaINFO *info;
+
+  (void) s;
+  (void) len;
+
+  NMEA_ASSERT(pack);
+  NMEA_ASSERT(merge);
+  NMEA_ASSERT(merge->info);
+
+  info = merge->info;
+
+  switch (type) {
+#if NMEA_SENTENCE_GGA
+    case GPGGA:
+      nmea_GPGGA2info((const nmeaGPGGA *) pack, info);
+      break;
+#endif
+
+#if NMEA_SENTENCE_GSA
+    case GPGSA:
+      nmea_GPGSA2info((const nmeaGPGSA *) pack, info);
+      break;
+#endif
+
+#if NMEA_SENTENCE_GSV
+    case GPGSV:
+      nmea_GPGSV2cycle((const nmeaGPGSV *) pack, &merge->gsv_cycle, info);
+      break;
+#endif
+
+#if NMEA_SENTENCE_RMC
+    case GPRMC:
+      nmea_GPRMC2info((const nmeaGPRMC *) pack, info);
+      break;
+#endif
+
+#if NMEA_SENTENCE_VTG
+    case GPVTG:
+      nmea_GPVTG2info((const nmeaGPVTG *) pack, info);
+      break;
+#endif
+
+    case GPNON:
+    default:
+      break;
+  }
+}
+
+/**
+ * Call the callback that is registered for the type of a decoded sentence
+ *
+ * @param parser a pointer to the parser
+ * @param type the sentence type
+ * @param pack a pointer to the decoded sentence
+ */
+static inline void nmea_parser_notify(nmeaPARSER *parser, const enum nmeaPACKTYPE type, const void *pack) {
+  int slot = nmea_parser_callback_slot(type);
+
+  if (parser->callbacks[slot].function) {
+    parser->callbacks[slot].function(type, pack, parser->buffer.buffer, (int) parser->buffer.length,
+        parser->callbacks[slot].arg);
+  }
+}
+
+/**
+ * Parse a string, without clearing the changed mask of the nmeaINFO structure
+ * (see nmea_parse)
+ *
+ * @param parser a pointer to the parser
+ * @param s the string
+ * @param len the length of the string
+ * @param info a pointer to the nmeaINFO structure, NULL to only call the callbacks
  * @return the number of packets that were parsed
  */
-int nmea_parse(nmeaPARSER * parser, const char * s, int len, nmeaINFO * info) {
+static int nmea_parse_string(nmeaPARSER * parser, const char * s, int len, nmeaINFO * info) {
   int sentences_count = 0;
   int charIndex = 0;
 
-  NMEA_ASSERT(parser);
-  NMEA_ASSERT(s);
-  NMEA_ASSERT(info);
+  NMEA_PARSER_COUNT(parser, bytes, len);
 
   for (charIndex = 0; charIndex < len; charIndex++) {
-    bool sentence_read_successfully = nmea_parse_sentence_character(parser, &s[charIndex]);
+    bool sentence_read_successfully;
+
+#if NMEA_BULK_SCAN
+    charIndex += nmea_parse_sentence_span(parser, &s[charIndex], len - charIndex);
+    if (charIndex >= len) {
+      break;
+    }
+#endif
+
+    sentence_read_successfully = nmea_parse_sentence_character(parser, &s[charIndex]);
     if (sentence_read_successfully) {
       enum nmeaPACKTYPE sentence_type = nmea_parse_get_sentence_type(&parser->buffer.buffer[1], parser->buffer.length - 1);
+
+      /* split the sentence once, the decoders work on the fields */
+      nmea_parse_fields(parser->buffer.buffer, parser->buffer.length, &parser->fields);
+
+      if (!parser->sentence_parser.has_checksum) {
+        NMEA_PARSER_COUNT(parser, no_checksum, 1);
+        continue;
+      }
+
       switch (sentence_type) {
+#if NMEA_SENTENCE_GGA
         case GPGGA:
-          if (nmea_parse_GPGGA(parser->buffer.buffer, parser->buffer.length, parser->sentence_parser.has_checksum, &parser->sentence.gpgga)) {
+          if (nmea_parse_GPGGA_fields(parser->buffer.buffer, parser->buffer.length, &parser->fields, parser->validation,
+              &parser->sentence.gpgga)) {
             sentences_count++;
-            nmea_GPGGA2info(&parser->sentence.gpgga, info);
+            NMEA_PARSER_COUNT(parser, sentences[0], 1);
+            nmea_parser_notify(parser, GPGGA, &parser->sentence.gpgga);
+            if (info) {
+              nmea_GPGGA2info(&parser->sentence.gpgga, info);
+            }
+            NMEA_PARSER_RECORD(parser, 0);
+          } else {
+            NMEA_PARSER_COUNT(parser, rejected[0], 1);
           }
           break;
+#endif
 
+#if NMEA_SENTENCE_GSA
         case GPGSA:
-          if (nmea_parse_GPGSA(parser->buffer.buffer, parser->buffer.length, parser->sentence_parser.has_checksum, &parser->sentence.gpgsa)) {
+          if (nmea_parse_GPGSA_fields(parser->buffer.buffer, parser->buffer.length, &parser->fields, parser->validation,
+              &parser->sentence.gpgsa)) {
             sentences_count++;
-            nmea_GPGSA2info(&parser->sentence.gpgsa, info);
+            NMEA_PARSER_COUNT(parser, sentences[1], 1);
+            nmea_parser_notify(parser, GPGSA, &parser->sentence.gpgsa);
+            if (info) {
+              nmea_GPGSA2info(&parser->sentence.gpgsa, info);
+            }
+            NMEA_PARSER_RECORD(parser, 1);
+          } else {
+            NMEA_PARSER_COUNT(parser, rejected[1], 1);
           }
           break;
+#endif
 
+#if NMEA_SENTENCE_GSV
         case GPGSV:
-          if (nmea_parse_GPGSV(parser->buffer.buffer, parser->buffer.length, parser->sentence_parser.has_checksum, &parser->sentence.gpgsv)) {
+          if (nmea_parse_GPGSV_fields(parser->buffer.buffer, parser->buffer.length, &parser->fields, parser->validation,
+              &parser->sentence.gpgsv)) {
             sentences_count++;
-            nmea_GPGSV2info(&parser->sentence.gpgsv, info);
+            NMEA_PARSER_COUNT(parser, sentences[2], 1);
+            nmea_parser_notify(parser, GPGSV, &parser->sentence.gpgsv);
+            if (info) {
+              /* merge the satellites of a cycle at once */
+              nmea_GPGSV2cycle(&parser->sentence.gpgsv, &parser->gsv_cycle, info);
+            }
+            NMEA_PARSER_RECORD(parser, 2);
+          } else {
+            NMEA_PARSER_COUNT(parser, rejected[2], 1);
           }
           break;
+#endif
 
+#if NMEA_SENTENCE_RMC
         case GPRMC:
-          if (nmea_parse_GPRMC(parser->buffer.buffer, parser->buffer.length, parser->sentence_parser.has_checksum, &parser->sentence.gprmc)) {
+          if (nmea_parse_GPRMC_fields(parser->buffer.buffer, parser->buffer.length, &parser->fields, parser->validation,
+              &parser->sentence.gprmc)) {
             sentences_count++;
-            nmea_GPRMC2info(&parser->sentence.gprmc, info);
+            NMEA_PARSER_COUNT(parser, sentences[3], 1);
+            nmea_parser_notify(parser, GPRMC, &parser->sentence.gprmc);
+            if (info) {
+              nmea_GPRMC2info(&parser->sentence.gprmc, info);
+            }
+            NMEA_PARSER_RECORD(parser, 3);
+          } else {
+            NMEA_PARSER_COUNT(parser, rejected[3], 1);
           }
           break;
+#endif
 
+#if NMEA_SENTENCE_VTG
         case GPVTG:
-          if (nmea_parse_GPVTG(parser->buffer.buffer, parser->buffer.length, parser->sentence_parser.has_checksum, &parser->sentence.gpvtg)) {
+          if (nmea_parse_GPVTG_fields(parser->buffer.buffer, parser->buffer.length, &parser->fields, parser->validation,
+              &parser->sentence.gpvtg)) {
             sentences_count++;
-            nmea_GPVTG2info(&parser->sentence.gpvtg, info);
+            NMEA_PARSER_COUNT(parser, sentences[4], 1);
+            nmea_parser_notify(parser, GPVTG, &parser->sentence.gpvtg);
+            if (info) {
+              nmea_GPVTG2info(&parser->sentence.gpvtg, info);
+            }
+            NMEA_PARSER_RECORD(parser, 4);
+          } else {
+            NMEA_PARSER_COUNT(parser, rejected[4], 1);
           }
           break;
+#endif
 
         case GPNON:
         default:
+          NMEA_PARSER_COUNT(parser, unknown, 1);
           break;
       }
     }
@@ -250,3 +765,208 @@ int nmea_parse(nmeaPARSER * parser, const char * s, int len, nmeaINFO * info) {
 
   return sentences_count;
 }
+
+/**
+ * Parse a string, pass every decoded sentence to the callback that is
+ * registered for its type (see nmea_parser_set_callback) and then merge it
+ * into the nmeaINFO structure. Afterwards the changed mask of the structure
+ * tells which fields changed in this call (see nmea_INFO_clear_changed).
+ *
+ * @param parser a pointer to the parser
+ * @param s the string
+ * @param len the length of the string
+ * @param info a pointer to the nmeaINFO structure, NULL to only call the callbacks
+ * @return the number of packets that were parsed
+ */
+int nmea_parse(nmeaPARSER * parser, const char * s, int len, nmeaINFO * info) {
+  NMEA_ASSERT(parser);
+  NMEA_ASSERT(s);
+
+  if (info) {
+    nmea_INFO_clear_changed(info);
+  }
+
+  return nmea_parse_string(parser, s, len, info);
+}
+
+/**
+ * Parse a string that consists of several segments, like nmea_parse, without
+ * copying them into one buffer first: for instance the two parts of a circular
+ * DMA buffer that wrapped. Sentences may straddle the segments.
+ *
+ * @param parser a pointer to the parser
+ * @param segments the segments, in order
+ * @param count the number of segments
+ * @param info a pointer to the nmeaINFO structure, NULL to only call the callbacks
+ * @return the number of packets that were parsed
+ */
+int nmea_parse_segments(nmeaPARSER * parser, const nmeaSEGMENT * segments, int count, nmeaINFO * info) {
+  int sentences_count = 0;
+  int segment;
+
+  NMEA_ASSERT(parser);
+  NMEA_ASSERT(segments || !count);
+
+  if (info) {
+    nmea_INFO_clear_changed(info);
+  }
+
+  for (segment = 0; segment < count; segment++) {
+    NMEA_ASSERT(segments[segment].s || !segments[segment].len);
+    sentences_count += nmea_parse_string(parser, segments[segment].s, segments[segment].len, info);
+  }
+
+  return sentences_count;
+}
+
+/**
+ * Parse the characters that are in a ring (the consumer side of the ring),
+ * like nmea_parse. The characters are parsed in place and released to the
+ * producer as soon as they are parsed. Only the characters that were in the
+ * ring when the call started are parsed, so that the call is bounded while the
+ * producer keeps writing.
+ *
+ * @param parser a pointer to the parser
+ * @param ring a pointer to the ring
+ * @param info a pointer to the nmeaINFO structure, NULL to only call the callbacks
+ * @return the number of packets that were parsed
+ */
+int nmea_parse_ring(nmeaPARSER * parser, nmeaRING * ring, nmeaINFO * info) {
+  int sentences_count = 0;
+  const char * s;
+  size_t pending;
+  size_t len;
+
+  NMEA_ASSERT(parser);
+  NMEA_ASSERT(ring);
+
+  if (info) {
+    nmea_INFO_clear_changed(info);
+  }
+
+  pending = nmea_ring_pending(ring);
+  while (pending && ((len = nmea_ring_peek(ring, &s)) > 0)) {
+    if (len > pending) {
+      len = pending;
+    }
+    sentences_count += nmea_parse_string(parser, s, (int) len, info);
+    nmea_ring_consume(ring, len);
+    pending -= len;
+  }
+
+  return sentences_count;
+}
+
+/**
+ * Get the statistics of the parser (see nmeaPARSERSTATS), all zero when
+ * NMEA_PARSER_STATS is disabled
+ *
+ * @param parser a pointer to the parser
+ * @param stats a pointer to the statistics (output)
+ */
+void nmea_parser_stats(const nmeaPARSER *parser, nmeaPARSERSTATS *stats) {
+  NMEA_ASSERT(parser);
+  NMEA_ASSERT(stats);
+
+#if NMEA_PARSER_STATS
+  *stats = parser->stats;
+#else
+  (void) parser;
+  memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+/**
+ * Reset the statistics of the parser
+ *
+ * @param parser a pointer to the parser
+ */
+void nmea_parser_reset_stats(nmeaPARSER *parser) {
+  NMEA_ASSERT(parser);
+
+#if NMEA_PARSER_STATS
+  memset(&parser->stats, 0, sizeof(parser->stats));
+#else
+  (void) parser;
+#endif
+}
+
+#if NMEA_PARSER_TRACE
+/**
+ * Get the latency measurements of the parser (see nmeaPARSERTRACE)
+ *
+ * @param parser a pointer to the parser
+ * @return a pointer to the measurements, valid until the next call of nmea_parse
+ */
+const nmeaPARSERTRACE * nmea_parser_trace(const nmeaPARSER *parser) {
+  NMEA_ASSERT(parser);
+  return &parser->trace;
+}
+
+/**
+ * Reset the latency measurements of the parser
+ *
+ * @param parser a pointer to the parser
+ */
+void nmea_parser_reset_trace(nmeaPARSER *parser) {
+  NMEA_ASSERT(parser);
+  memset(&parser->trace, 0, sizeof(parser->trace));
+}
+
+/**
+ * Get a percentile of a latency histogram, rounded up to the upper bound of
+ * its bucket
+ *
+ * @param latency a pointer to the histogram
+ * @param percent the percentile (0 - 100)
+ * @return the latency in ticks below which (at least) the percentile of the latencies lie, 0 for an empty histogram
+ */
+uint32_t nmea_latency_percentile(const nmeaLATENCY *latency, const unsigned int percent) {
+  uint64_t rank;
+  uint64_t seen = 0;
+  int bucket;
+
+  NMEA_ASSERT(latency);
+
+  if (!latency->count) {
+    return 0;
+  }
+
+  rank = (((uint64_t) latency->count * (percent < 100 ? percent : 100)) + 99) / 100;
+  for (bucket = 0; bucket < NMEA_TRACE_BUCKETS; bucket++) {
+    seen += latency->buckets[bucket];
+    if (seen && (seen >= rank)) {
+      uint32_t upper = (bucket < 31) ? ((2u << bucket) - 1) : UINT32_MAX;
+      return (upper < latency->max) ? upper : latency->max;
+    }
+  }
+
+  return latency->max;
+}
+#endif
+
+/**
+ * Get the fields of the sentence that was framed last.
+ * The fields are slices of the parser buffer and remain valid until the start
+ * of a next sentence is fed to the parser.
+ *
+ * @param parser a pointer to the parser
+ * @return a pointer to the fields, of which the count is 0 when no sentence is framed
+ */
+const nmeaFIELDS * nmea_parser_fields(const nmeaPARSER *parser) {
+  NMEA_ASSERT(parser);
+  return &parser->fields;
+}
+
+/**
+ * Get a field of the sentence that was framed last, without copying it.
+ *
+ * @param parser a pointer to the parser
+ * @param index the index of the field (0 is the address field)
+ * @param len a pointer to the length of the field (output), 0 when the field is absent
+ * @return a pointer to the start of the field (not NUL-terminated), or NULL when absent
+ */
+const char * nmea_parser_field(const nmeaPARSER *parser, const int index, int *len) {
+  NMEA_ASSERT(parser);
+  return nmea_parse_field(parser->buffer.buffer, &parser->fields, index, len);
+}
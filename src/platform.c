@@ -0,0 +1,40 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmea/nmeaconf.h>
+#include <nmea/platform.h>
+
+/**
+ * Get the date and time of the real-time clock
+ *
+ * @param tm a pointer to the date and time (output)
+ * @param msec a pointer to the milliseconds (output)
+ */
+void nmea_platform_time(struct tm *tm, uint32_t *msec) {
+#if NMEA_PLATFORM == NMEA_PLATFORM_CHIBIOS
+  RTCDateTime timespec;
+
+  rtcGetTime(&RTCD1, &timespec);
+  rtcConvertDateTimeToStructTm(&timespec, tm, msec);
+#else
+  struct timespec now;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+  gmtime_r(&now.tv_sec, tm);
+  *msec = (uint32_t) (now.tv_nsec / 1000000);
+#endif
+}
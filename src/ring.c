@@ -0,0 +1,174 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmea/ring.h>
+
+#include <string.h>
+
+#define NMEA_RING_MASK (NMEA_RING_SIZE - 1u)
+
+/**
+ * Initialise (empty) the ring and reset its counters.
+ * Initialise the ring before the producer and the consumer use it.
+ *
+ * @param ring a pointer to the ring
+ */
+void nmea_ring_init(nmeaRING *ring) {
+  NMEA_ASSERT(ring);
+
+  atomic_init(&ring->producer.head, 0);
+  ring->producer.tail = 0;
+  atomic_init(&ring->producer.overruns, 0);
+  atomic_init(&ring->producer.dropped, 0);
+  atomic_init(&ring->consumer.tail, 0);
+  ring->consumer.head = 0;
+}
+
+/**
+ * Write characters into the ring (producer side), never blocks.
+ * The characters that do not fit are dropped and counted, the parser discards
+ * the sentence that they belonged to on its checksum. Can be called from an
+ * interrupt handler.
+ *
+ * @param ring a pointer to the ring
+ * @param s the characters
+ * @param len the number of characters
+ * @return the number of characters that were written
+ */
+size_t nmea_ring_write(nmeaRING *ring, const char *s, size_t len) {
+  unsigned int head;
+  unsigned int index;
+  size_t room;
+  size_t first;
+
+  NMEA_ASSERT(ring);
+  NMEA_ASSERT(s || !len);
+
+  head = atomic_load_explicit(&ring->producer.head, memory_order_relaxed);
+  room = NMEA_RING_SIZE - (head - ring->producer.tail);
+  if (room < len) {
+    /* refresh the copy of the read index only when the ring looks full */
+    ring->producer.tail = atomic_load_explicit(&ring->consumer.tail, memory_order_acquire);
+    room = NMEA_RING_SIZE - (head - ring->producer.tail);
+  }
+
+  if (room < len) {
+    atomic_fetch_add_explicit(&ring->producer.overruns, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ring->producer.dropped, (unsigned int) (len - room), memory_order_relaxed);
+    len = room;
+  }
+
+  if (!len) {
+    return 0;
+  }
+
+  index = head & NMEA_RING_MASK;
+  first = NMEA_RING_SIZE - index;
+  if (first > len) {
+    first = len;
+  }
+
+  memcpy(&ring->buffer[index], s, first);
+  memcpy(ring->buffer, &s[first], len - first);
+
+  atomic_store_explicit(&ring->producer.head, head + (unsigned int) len, memory_order_release);
+  return len;
+}
+
+/**
+ * Get the number of characters that can be read from the ring (consumer
+ * side), reading the write index of the producer once
+ *
+ * @param ring a pointer to the ring
+ * @return the number of characters, 0 when the ring is empty
+ */
+size_t nmea_ring_pending(nmeaRING *ring) {
+  NMEA_ASSERT(ring);
+
+  ring->consumer.head = atomic_load_explicit(&ring->producer.head, memory_order_acquire);
+  return ring->consumer.head - atomic_load_explicit(&ring->consumer.tail, memory_order_relaxed);
+}
+
+/**
+ * Get the characters that can be read from the ring without copying them
+ * (consumer side). At the end of the buffer the characters are returned in two
+ * parts: this returns the first one, the next call after nmea_ring_consume the
+ * second one.
+ *
+ * @param ring a pointer to the ring
+ * @param s a pointer to the start of the characters (output)
+ * @return the number of characters, 0 when the ring is empty
+ */
+size_t nmea_ring_peek(nmeaRING *ring, const char **s) {
+  unsigned int tail;
+  unsigned int index;
+  size_t available;
+
+  NMEA_ASSERT(ring);
+  NMEA_ASSERT(s);
+
+  tail = atomic_load_explicit(&ring->consumer.tail, memory_order_relaxed);
+  if (ring->consumer.head == tail) {
+    /* refresh the copy of the write index only when the ring looks empty */
+    ring->consumer.head = atomic_load_explicit(&ring->producer.head, memory_order_acquire);
+  }
+
+  available = ring->consumer.head - tail;
+  index = tail & NMEA_RING_MASK;
+  if (available > (NMEA_RING_SIZE - index)) {
+    available = NMEA_RING_SIZE - index;
+  }
+
+  *s = &ring->buffer[index];
+  return available;
+}
+
+/**
+ * Release characters that were read (consumer side), the producer can then
+ * overwrite them.
+ *
+ * @param ring a pointer to the ring
+ * @param len the number of characters, at most the number that nmea_ring_peek returned
+ */
+void nmea_ring_consume(nmeaRING *ring, size_t len) {
+  unsigned int tail;
+
+  NMEA_ASSERT(ring);
+
+  tail = atomic_load_explicit(&ring->consumer.tail, memory_order_relaxed);
+  NMEA_ASSERT(len <= (size_t) (ring->consumer.head - tail));
+
+  atomic_store_explicit(&ring->consumer.tail, tail + (unsigned int) len, memory_order_release);
+}
+
+/**
+ * Get the overrun counters of the ring, can be called from any thread
+ *
+ * @param ring a pointer to the ring
+ * @param overruns a pointer to the number of writes that did not fit (output), may be NULL
+ * @param dropped a pointer to the number of characters that were dropped (output), may be NULL
+ */
+void nmea_ring_counters(nmeaRING *ring, unsigned int *overruns, unsigned int *dropped) {
+  NMEA_ASSERT(ring);
+
+  if (overruns) {
+    *overruns = atomic_load_explicit(&ring->producer.overruns, memory_order_relaxed);
+  }
+  if (dropped) {
+    *dropped = atomic_load_explicit(&ring->producer.dropped, memory_order_relaxed);
+  }
+}
@@ -0,0 +1,168 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmea/scan.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+/**
+ * Determine whether a character is a plain sentence character: a character
+ * that is allowed in a sentence and that has no special meaning to the frame
+ * parser. These are exactly the characters for which isInvalidNMEACharacter
+ * returns 0, which excludes '$', '*', CR and LF.
+ *
+ * @param c the character
+ * @return true when the character is a plain sentence character
+ */
+static inline bool isPlainChar(const char c) {
+  return ((c >= 32) && (c <= 126) && (c != '$') && (c != '*') && (c != '!') && (c != '\\') && (c != '^')
+      && (c != '~'));
+}
+
+#if defined(__AVX2__)
+/**
+ * Determine which characters of a block are not plain sentence characters.
+ *
+ * @param v the block
+ * @return a bit mask with a bit set for every character that is not plain
+ */
+static inline uint32_t _nmea_scan_mask(const __m256i v) {
+  __m256i plain = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(31)),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8(127), v));
+  __m256i special = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('$')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('*'))),
+      _mm256_or_si256(
+          _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('!')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+          _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('^')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('~')))));
+
+  return ~(uint32_t) _mm256_movemask_epi8(_mm256_andnot_si256(special, plain));
+}
+#elif defined(__SSE2__)
+/**
+ * Determine which characters of a block are not plain sentence characters.
+ *
+ * @param v the block
+ * @return a bit mask with a bit set for every character that is not plain
+ */
+static inline uint32_t _nmea_scan_mask(const __m128i v) {
+  __m128i plain = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(31)), _mm_cmplt_epi8(v, _mm_set1_epi8(127)));
+  __m128i special = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('$')), _mm_cmpeq_epi8(v, _mm_set1_epi8('*'))),
+      _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('!')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+          _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('^')), _mm_cmpeq_epi8(v, _mm_set1_epi8('~')))));
+
+  return (~(uint32_t) _mm_movemask_epi8(_mm_andnot_si128(special, plain))) & 0xffffu;
+}
+#endif
+
+/**
+ * Scan a string for the longest prefix of plain sentence characters (see
+ * isInvalidNMEACharacter) and XOR that prefix into a checksum.
+ * The scan stops at the first '$', '*', CR, LF or invalid character, which is
+ * the first character that the frame parser has to look at individually.
+ *
+ * Uses AVX2 or SSE2 when the compiler targets them, a scalar loop otherwise.
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param checksum a pointer to the checksum into which the prefix is XOR-ed
+ * @return the length of the prefix
+ */
+size_t nmea_scan_sentence(const char *s, const size_t len, int *checksum) {
+  size_t i = 0;
+  int x = 0;
+
+  NMEA_ASSERT(s);
+  NMEA_ASSERT(checksum);
+
+#if defined(__AVX2__)
+  {
+    __m256i acc = _mm256_setzero_si256();
+    __m128i acc128;
+    uint32_t mask = 0;
+
+    for (; (i + 32) <= len; i += 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i *) (const void *) &s[i]);
+      mask = _nmea_scan_mask(v);
+      if (mask) {
+        break;
+      }
+      acc = _mm256_xor_si256(acc, v);
+    }
+
+    acc128 = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    acc128 = _mm_xor_si128(acc128, _mm_srli_si128(acc128, 8));
+    acc128 = _mm_xor_si128(acc128, _mm_srli_si128(acc128, 4));
+    acc128 = _mm_xor_si128(acc128, _mm_srli_si128(acc128, 2));
+    acc128 = _mm_xor_si128(acc128, _mm_srli_si128(acc128, 1));
+    x = _mm_cvtsi128_si32(acc128) & 0xff;
+
+    if (mask) {
+      size_t end = i + (size_t) __builtin_ctz(mask);
+      for (; i < end; i++) {
+        x ^= s[i];
+      }
+      *checksum ^= x;
+      return i;
+    }
+  }
+#elif defined(__SSE2__)
+  {
+    __m128i acc = _mm_setzero_si128();
+    uint32_t mask = 0;
+
+    for (; (i + 16) <= len; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *) (const void *) &s[i]);
+      mask = _nmea_scan_mask(v);
+      if (mask) {
+        break;
+      }
+      acc = _mm_xor_si128(acc, v);
+    }
+
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 2));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 1));
+    x = _mm_cvtsi128_si32(acc) & 0xff;
+
+    if (mask) {
+      size_t end = i + (size_t) __builtin_ctz(mask);
+      for (; i < end; i++) {
+        x ^= s[i];
+      }
+      *checksum ^= x;
+      return i;
+    }
+  }
+#endif
+
+  for (; (i < len) && isPlainChar(s[i]); i++) {
+    x ^= s[i];
+  }
+
+  *checksum ^= x;
+  return i;
+}
@@ -0,0 +1,126 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <nmea/snapshot.h>
+
+#include <string.h>
+
+/**
+ * Initialise the publication, nothing is published yet.
+ * Initialise it before the writer and the readers use it.
+ *
+ * @param snapshot a pointer to the publication
+ */
+void nmea_snapshot_init(nmeaSNAPSHOT *snapshot) {
+  size_t buffer;
+  size_t word;
+
+  NMEA_ASSERT(snapshot);
+
+  atomic_init(&snapshot->version, 0);
+  for (buffer = 0; buffer < 2; buffer++) {
+    atomic_init(&snapshot->buffers[buffer].sequence, 0);
+    for (word = 0; word < NMEA_SNAPSHOT_WORDS; word++) {
+      atomic_init(&snapshot->buffers[buffer].words[word], 0);
+    }
+  }
+}
+
+/**
+ * Publish a copy of an nmeaINFO structure (writer side, one writer only).
+ * Never waits for the readers. Publish after nmea_parse (or from an epoch
+ * callback), the changed mask of the copy is that of the structure.
+ *
+ * @param snapshot a pointer to the publication
+ * @param info a pointer to the nmeaINFO structure
+ */
+void nmea_snapshot_publish(nmeaSNAPSHOT *snapshot, const nmeaINFO *info) {
+  unsigned int version;
+  size_t word;
+
+  NMEA_ASSERT(snapshot);
+  NMEA_ASSERT(info);
+
+  version = atomic_load_explicit(&snapshot->version, memory_order_relaxed) + 1;
+
+  /* odd: a reader that copies the buffer now retries */
+  atomic_store_explicit(&snapshot->buffers[version & 1].sequence, (version * 2) - 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  for (word = 0; word < NMEA_SNAPSHOT_WORDS; word++) {
+    uint32_t value;
+
+    memcpy(&value, (const char *) info + (word * sizeof(value)), sizeof(value));
+    atomic_store_explicit(&snapshot->buffers[version & 1].words[word], value, memory_order_relaxed);
+  }
+
+  atomic_store_explicit(&snapshot->buffers[version & 1].sequence, version * 2, memory_order_release);
+  atomic_store_explicit(&snapshot->version, version, memory_order_release);
+}
+
+/**
+ * Get the number of publications, a cheap check for a new structure
+ *
+ * @param snapshot a pointer to the publication
+ * @return the number of publications, 0 when nothing was published yet
+ */
+unsigned int nmea_snapshot_version(nmeaSNAPSHOT *snapshot) {
+  NMEA_ASSERT(snapshot);
+  return atomic_load_explicit(&snapshot->version, memory_order_acquire);
+}
+
+/**
+ * Take a consistent copy of the last published nmeaINFO structure (reader
+ * side, any number of readers). Never blocks the writer, retries only when
+ * the writer published twice during the copy.
+ *
+ * @param snapshot a pointer to the publication
+ * @param info a pointer to the nmeaINFO structure (output), untouched when nothing was published yet
+ * @return the publication number of the copy (see nmea_snapshot_version), 0 when nothing was published yet
+ */
+unsigned int nmea_snapshot_read(nmeaSNAPSHOT *snapshot, nmeaINFO *info) {
+  NMEA_ASSERT(snapshot);
+  NMEA_ASSERT(info);
+
+  for (;;) {
+    unsigned int version;
+    unsigned int sequence;
+    size_t word;
+
+    version = atomic_load_explicit(&snapshot->version, memory_order_acquire);
+    if (!version) {
+      return 0;
+    }
+
+    /* the buffer is being written, or holds a later publication already */
+    sequence = atomic_load_explicit(&snapshot->buffers[version & 1].sequence, memory_order_acquire);
+    if (sequence != (version * 2)) {
+      continue;
+    }
+
+    for (word = 0; word < NMEA_SNAPSHOT_WORDS; word++) {
+      uint32_t value = atomic_load_explicit(&snapshot->buffers[version & 1].words[word], memory_order_relaxed);
+
+      memcpy((char *) info + (word * sizeof(value)), &value, sizeof(value));
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&snapshot->buffers[version & 1].sequence, memory_order_relaxed) == sequence) {
+      return version;
+    }
+  }
+}
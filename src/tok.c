@@ -18,7 +18,10 @@
 #include <nmea/tok.h>
 
 #include <ctype.h>
+#include <limits.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,47 +31,298 @@
 #define NMEA_TOKS_WIDTH     3
 #define NMEA_TOKS_TYPE      4
 
+#if NMEA_SINGLE_PRECISION
+/** the powers of 10 that are exactly representable as a float */
+static const nmeaFLOAT nmea_pow10[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+#else
+/** the powers of 10 that are exactly representable as a double */
+static const nmeaFLOAT nmea_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** the largest mantissa that is exactly representable as a double */
+#define NMEA_ATOF_EXACT     (UINT64_C(1) << 53)
+#endif
+
+/** the maximum number of significant digits that are accumulated */
+#define NMEA_ATOF_DIGITS    19
+
+/** the maximum number of integer digits for nmea_atofixed (with a scale of at most 10^9 that fits an int64_t) */
+#define NMEA_ATOFIXED_DIGITS 9
+
 /**
- * Convert string to an integer
+ * Determine whether a character is white space, in the "C" locale.
+ *
+ * @param c the character
+ * @return true when the character is white space
+ */
+static inline bool isSpaceChar(const char c) {
+  return ((c == ' ') || ((c >= '\t') && (c <= '\r')));
+}
+
+/**
+ * Determine the value of a digit in any radix up to 36.
+ *
+ * @param c the character
+ * @return the value of the digit, or 36 when the character is not a digit
+ */
+static inline unsigned int digitValue(const char c) {
+  if ((c >= '0') && (c <= '9')) {
+    return (unsigned int) (c - '0');
+  }
+  if ((c >= 'a') && (c <= 'z')) {
+    return (unsigned int) (c - 'a' + 10);
+  }
+  if ((c >= 'A') && (c <= 'Z')) {
+    return (unsigned int) (c - 'A' + 10);
+  }
+  return 36;
+}
+
+/**
+ * Convert string to an integer.
+ * Works directly on the string (which does not have to be NUL-terminated) and
+ * does not depend on the locale. Like strtol, leading white space and a sign
+ * are accepted and conversion stops at the first character that is not a
+ * digit. Results that do not fit an int are clamped.
  *
  * @param s the string
  * @param len the length of the string
  * @param radix the radix of the numbers in the string
  * @return the converted number, or 0 on failure
  */
-int nmea_atoi(const char *s, int len, int radix) {
-	char *tmp_ptr;
-	char buff[NMEA_CONVSTR_BUF];
-	long res = 0;
-
-	if (len < NMEA_CONVSTR_BUF-1) {
-		memcpy(&buff[0], s, len);
-		buff[len] = '\0';
-		res = strtol(&buff[0], &tmp_ptr, radix);
-	}
+int nmea_atoi(const char *s, const int len, const int radix) {
+  const char *end = s + len;
+  bool negative = false;
+  unsigned long res = 0;
+  unsigned long limit;
 
-	return (int) res;
+  if ((radix < 2) || (radix > 36)) {
+    return 0;
+  }
+
+  while ((s < end) && isSpaceChar(*s)) {
+    s++;
+  }
+
+  if ((s < end) && ((*s == '-') || (*s == '+'))) {
+    negative = (*s == '-');
+    s++;
+  }
+
+  if ((radix == 16) && ((end - s) > 2) && (s[0] == '0') && ((s[1] == 'x') || (s[1] == 'X'))
+      && (digitValue(s[2]) < 16)) {
+    s += 2;
+  }
+
+  limit = negative ? ((unsigned long) INT_MAX + 1) : (unsigned long) INT_MAX;
+
+  for (; s < end; s++) {
+    unsigned int digit = digitValue(*s);
+    if (digit >= (unsigned int) radix) {
+      break;
+    }
+
+    res = (res * (unsigned int) radix) + digit;
+    if (res > limit) {
+      res = limit;
+      break;
+    }
+  }
+
+  if (negative) {
+    return (res > (unsigned long) INT_MAX) ? INT_MIN : -(int) res;
+  }
+
+  return (int) res;
 }
 
 /**
- * Convert string to a floating point number
+ * Convert string to a floating point number using strtod (strtof in single
+ * precision), for the numbers that nmea_atof can not convert by itself.
  *
  * @param s the string
  * @param len the length of the string
  * @return the converted number, or 0 on failure
  */
-double nmea_atof(const char *s, const int len) {
-	char *tmp_ptr;
-	char buff[NMEA_CONVSTR_BUF];
-	double res = 0;
-
-	if (len < NMEA_CONVSTR_BUF-1) {
-		memcpy(&buff[0], s, len);
-		buff[len] = '\0';
-		res = strtod(&buff[0], &tmp_ptr);
-	}
+static nmeaFLOAT nmea_atof_strtod(const char *s, const int len) {
+  char *tmp_ptr;
+  char buff[NMEA_CONVSTR_BUF];
+  nmeaFLOAT res = 0;
+
+  if (len < NMEA_CONVSTR_BUF-1) {
+    memcpy(&buff[0], s, len);
+    buff[len] = '\0';
+#if NMEA_SINGLE_PRECISION
+    res = strtof(&buff[0], &tmp_ptr);
+#else
+    res = strtod(&buff[0], &tmp_ptr);
+#endif
+  }
+
+  return res;
+}
+
+/**
+ * Convert string to a floating point number.
+ * Works directly on the string (which does not have to be NUL-terminated) and
+ * does not depend on the locale. Decimal numbers with up to 19 significant
+ * digits (which covers everything NMEA sends, like ddmm.mmmmm, hhmmss.sss,
+ * DOPs and speeds) are converted exactly: the digits are accumulated in an
+ * integer which is divided once by an exact power of 10, giving the correctly
+ * rounded result (the same result as strtod). Anything else (more digits,
+ * exponents, hex, inf, nan) is handed to strtod.
+ *
+ * In single precision the result is a float. It is correctly rounded when
+ * the digits fit the 24 bit float mantissa (up to 7 digits). Longer numbers
+ * (like ddmm.mmmmm) are not handed to strtof but are converted as the sum of
+ * the whole part and the fraction, which is within 1 ulp (and within half an
+ * ulp plus the rounding of the fraction when the whole part is exact).
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @return the converted number, or 0 on failure
+ */
+nmeaFLOAT nmea_atof(const char *s, const int len) {
+  const char *start = s;
+  const char *end = s + len;
+  bool negative = false;
+  const char *number;
+  uint64_t mantissa = 0;
+#if NMEA_SINGLE_PRECISION
+  uint64_t whole;
+  uint64_t fraction = 0;
+#endif
+  int digits = 0;
+  int decimals = 0;
+  nmeaFLOAT res;
+
+  while ((s < end) && isSpaceChar(*s)) {
+    s++;
+  }
+
+  if ((s < end) && ((*s == '-') || (*s == '+'))) {
+    negative = (*s == '-');
+    s++;
+  }
+
+  number = s;
+  for (; (s < end) && (*s >= '0') && (*s <= '9'); s++) {
+    if (mantissa || (*s != '0')) {
+      if (++digits > NMEA_ATOF_DIGITS) {
+        return nmea_atof_strtod(start, len);
+      }
+      mantissa = (mantissa * 10) + (uint64_t) (*s - '0');
+    }
+  }
+
+#if NMEA_SINGLE_PRECISION
+  whole = mantissa;
+#endif
+
+  if ((s < end) && (*s == '.')) {
+    for (s++; (s < end) && (*s >= '0') && (*s <= '9'); s++) {
+      if (mantissa || (*s != '0')) {
+        if (++digits > NMEA_ATOF_DIGITS) {
+          return nmea_atof_strtod(start, len);
+        }
+      }
+      mantissa = (mantissa * 10) + (uint64_t) (*s - '0');
+#if NMEA_SINGLE_PRECISION
+      fraction = (fraction * 10) + (uint64_t) (*s - '0');
+#endif
+      decimals++;
+    }
+  }
+
+  if ((s == number) || ((s == (number + 1)) && (*number == '.'))) {
+    /* no digits, like strtod check for inf and nan */
+    return ((s < end) && (digitValue(*s) < 36)) ? nmea_atof_strtod(start, len) : 0;
+  }
+
+  if ((s < end) && (digitValue(*s) < 36)) {
+    /* exponent, hex, inf or nan */
+    return nmea_atof_strtod(start, len);
+  }
+
+  if (decimals >= (int) (sizeof(nmea_pow10) / sizeof(nmea_pow10[0]))) {
+    return nmea_atof_strtod(start, len);
+  }
+
+#if NMEA_SINGLE_PRECISION
+  if (mantissa > (UINT64_C(1) << 24)) {
+    res = (nmeaFLOAT) whole + ((nmeaFLOAT) fraction / nmea_pow10[decimals]);
+  } else {
+    res = (nmeaFLOAT) mantissa / nmea_pow10[decimals];
+  }
+#else
+  if (mantissa > NMEA_ATOF_EXACT) {
+    return nmea_atof_strtod(start, len);
+  }
+
+  res = (nmeaFLOAT) mantissa / nmea_pow10[decimals];
+#endif
+  return (negative ? -res : res);
+}
+
+/**
+ * Convert string to a fixed point number, without any floating point
+ * arithmetic. Works directly on the string (which does not have to be
+ * NUL-terminated). Leading white space and a sign are accepted, conversion
+ * stops at the first character that is not part of a decimal number (so
+ * exponents are not supported). Numbers that do not fit are clamped.
+ *
+ * @param s the string
+ * @param len the length of the string
+ * @param scale the scale of the result, a power of 10 (1 <= scale <= 10^9)
+ * @return the converted number multiplied by scale and rounded (half away
+ * from zero), or 0 on failure
+ */
+int64_t nmea_atofixed(const char *s, const int len, const int32_t scale) {
+  const char *end = s + len;
+  bool negative = false;
+  int64_t res = 0;
+  int32_t unit = scale;
+  int digits = 0;
+
+  NMEA_ASSERT(scale > 0);
+
+  while ((s < end) && isSpaceChar(*s)) {
+    s++;
+  }
+
+  if ((s < end) && ((*s == '-') || (*s == '+'))) {
+    negative = (*s == '-');
+    s++;
+  }
+
+  for (; (s < end) && (*s >= '0') && (*s <= '9'); s++) {
+    if (res || (*s != '0')) {
+      if (++digits > NMEA_ATOFIXED_DIGITS) {
+        return (negative ? -INT64_MAX : INT64_MAX);
+      }
+      res = (res * 10) + (*s - '0');
+    }
+  }
+
+  res *= scale;
+
+  if ((s < end) && (*s == '.')) {
+    for (s++; (s < end) && (*s >= '0') && (*s <= '9'); s++) {
+      if (unit == 1) {
+        /* first digit beyond the scale, round */
+        res += ((*s >= '5') ? 1 : 0);
+        break;
+      }
+      unit /= 10;
+      res += (*s - '0') * unit;
+    }
+  }
 
-	return res;
+  return (negative ? -res : res);
 }
 
 /**
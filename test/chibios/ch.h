@@ -0,0 +1,44 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The part of the ChibiOS kernel API that the ChibiOS platform layer uses
+ * (see include/nmea/platform.h), on top of POSIX, for building the library
+ * with NMEA_PLATFORM_CHIBIOS on the host
+ */
+
+#ifndef CH_H
+#define CH_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <time.h>
+
+#define chDbgAssert(c, r) assert(c)
+
+/**
+ * @return nanoseconds of the monotonic clock, the realtime counter
+ */
+static inline uint32_t chSysGetRealtimeCounterX(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t) (((uint64_t) now.tv_sec * 1000000000u) + (uint64_t) now.tv_nsec);
+}
+
+#endif /* CH_H */
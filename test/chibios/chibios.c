@@ -0,0 +1,65 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The drivers of the ChibiOS stubs: make test links the tests against a build
+ * of the library with NMEA_PLATFORM_CHIBIOS and this file, to check that the
+ * firmware platform layer parses and merges like the POSIX one
+ */
+
+#include "hal.h"
+
+RTCDriver RTCD1;
+SerialUSBDriver SDU1;
+
+/**
+ * Get the date and time of the host clock
+ */
+void rtcGetTime(RTCDriver *rtcp, RTCDateTime *timespec) {
+  struct timespec now;
+  struct tm tm;
+
+  (void) rtcp;
+  clock_gettime(CLOCK_REALTIME, &now);
+  gmtime_r(&now.tv_sec, &tm);
+  timespec->year = (uint32_t) tm.tm_year - (1980U - 1900U);
+  timespec->month = (uint32_t) tm.tm_mon + 1U;
+  timespec->dstflag = 0U;
+  timespec->dayofweek = tm.tm_wday ? (uint32_t) tm.tm_wday : RTC_DAY_SUNDAY;
+  timespec->day = (uint32_t) tm.tm_mday;
+  timespec->millisecond = (uint32_t) (((tm.tm_hour * 3600) + (tm.tm_min * 60) + tm.tm_sec) * 1000)
+      + (uint32_t) (now.tv_nsec / 1000000);
+}
+
+/**
+ * Convert a date and time of the RTC into a struct tm and milliseconds
+ */
+void rtcConvertDateTimeToStructTm(const RTCDateTime *timespec, struct tm *timp, uint32_t *tv_msec) {
+  uint32_t seconds = timespec->millisecond / 1000U;
+
+  timp->tm_year = (int) timespec->year + (1980 - 1900);
+  timp->tm_mon = (int) timespec->month - 1;
+  timp->tm_mday = (int) timespec->day;
+  timp->tm_wday = (int) (timespec->dayofweek % 7U);
+  timp->tm_hour = (int) (seconds / 3600U);
+  timp->tm_min = (int) ((seconds / 60U) % 60U);
+  timp->tm_sec = (int) (seconds % 60U);
+  timp->tm_isdst = 0;
+  if (tv_msec)
+    *tv_msec = timespec->millisecond % 1000U;
+}
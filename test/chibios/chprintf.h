@@ -0,0 +1,30 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * chprintf of ChibiOS, printing to the standard output
+ */
+
+#ifndef CHPRINTF_H
+#define CHPRINTF_H
+
+#include <stdio.h>
+
+#define chprintf(chp, ...) ((void) (chp), printf(__VA_ARGS__))
+
+#endif /* CHPRINTF_H */
@@ -0,0 +1,60 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The part of the ChibiOS HAL API that the ChibiOS platform layer uses (see
+ * include/nmea/platform.h): the RTC driver over the host clock and the
+ * serial USB driver of NMEASD
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <time.h>
+
+#define RTC_DAY_SUNDAY 7
+
+typedef struct {
+  uint32_t year;        /**< Years since 1980 */
+  uint32_t month;       /**< Months [1,12] */
+  uint32_t dstflag;     /**< Daylight saving time */
+  uint32_t dayofweek;   /**< Day of the week [1,7], 7 is Sunday */
+  uint32_t day;         /**< Day of the month [1,31] */
+  uint32_t millisecond; /**< Milliseconds since midnight */
+} RTCDateTime;
+
+typedef struct {
+  int unused;
+} RTCDriver;
+
+typedef struct {
+  int unused;
+} BaseSequentialStream;
+
+typedef struct {
+  int unused;
+} SerialUSBDriver;
+
+extern RTCDriver RTCD1;
+extern SerialUSBDriver SDU1;
+
+void rtcGetTime(RTCDriver *rtcp, RTCDateTime *timespec);
+void rtcConvertDateTimeToStructTm(const RTCDateTime *timespec, struct tm *timp, uint32_t *tv_msec);
+
+#endif /* HAL_H */
@@ -0,0 +1,386 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Decoder test: decodes known GGA, GSA, GSV, RMC and VTG sentences at each
+ * validation level and checks the return value and the present mask, then
+ * the values of the well-formed sentences and the marks of the absent fields.
+ */
+
+#include "test.h"
+
+#include <nmea/parse.h>
+
+#define NONE        VALIDATE_NONE
+#define STRUCTURAL  VALIDATE_STRUCTURAL
+#define FULL        VALIDATE_FULL
+
+/**
+ * The sentence structures of the decoders
+ */
+typedef union _PACKS {
+#if NMEA_SENTENCE_GGA
+  nmeaGPGGA gga;
+#endif
+#if NMEA_SENTENCE_GSA
+  nmeaGPGSA gsa;
+#endif
+#if NMEA_SENTENCE_GSV
+  nmeaGPGSV gsv;
+#endif
+#if NMEA_SENTENCE_RMC
+  nmeaGPRMC rmc;
+#endif
+#if NMEA_SENTENCE_VTG
+  nmeaGPVTG vtg;
+#endif
+  uint32_t present;
+} PACKS;
+
+/**
+ * A sentence, the validation level and the expected result
+ */
+typedef struct _DECODE {
+  const char *body;                   /**< The sentence up to and including the '*' */
+  enum nmeaVALIDATION validation;     /**< The validation level */
+  int parsed;                         /**< The expected return value of the decoder */
+  uint32_t present;                   /**< The expected present mask, when parsed */
+} DECODE;
+
+static const DECODE decodes[] = {
+#if NMEA_SENTENCE_GGA
+    { "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", FULL, 1,
+        UTCTIME | LAT | LON | SIG | SATINUSECOUNT | HDOP | ELV },
+    { "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", NONE, 1,
+        UTCTIME | LAT | LON | SIG | SATINUSECOUNT | HDOP | ELV },
+    { "$GPGGA,,,,,,,,,,,,,,*", FULL, 1, 0 },
+    { "$GPGGA,,,,,,,,,,,,,,*", NONE, 1, 0 },
+    /* 13 tokens */
+    { "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M*", FULL, 0, 0 },
+    { "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M*", NONE, 0, 0 },
+    /* a malformed time */
+    { "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", FULL, 0, 0 },
+    { "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", STRUCTURAL, 0, 0 },
+    { "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", NONE, 1,
+        LAT | LON | SIG | SATINUSECOUNT | HDOP | ELV },
+    /* a time out of range */
+    { "$GPGGA,253519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", FULL, 0, 0 },
+    { "$GPGGA,253519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", STRUCTURAL, 1,
+        UTCTIME | LAT | LON | SIG | SATINUSECOUNT | HDOP | ELV },
+    /* a latitude without its hemisphere, an altitude without its unit */
+    { "$GPGGA,123519.000,4807.038,,01131.000,E,1,08,0.9,545.4,,46.9,M,,*", FULL, 1,
+        UTCTIME | LON | SIG | SATINUSECOUNT | HDOP },
+    { "$GPGGA,123519.000,4807.038,,01131.000,E,1,08,0.9,545.4,,46.9,M,,*", NONE, 1,
+        UTCTIME | LON | SIG | SATINUSECOUNT | HDOP | ELV },
+    /* a hemisphere, a signal quality and a unit that are out of range */
+    { "$GPGGA,123519.000,4807.038,X,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", FULL, 0, 0 },
+    { "$GPGGA,123519.000,4807.038,X,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", STRUCTURAL, 1,
+        UTCTIME | LAT | LON | SIG | SATINUSECOUNT | HDOP | ELV },
+    { "$GPGGA,123519.000,4807.038,N,01131.000,E,9,08,0.9,545.4,M,46.9,M,,*", FULL, 0, 0 },
+    { "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,F,46.9,M,,*", FULL, 0, 0 },
+    /* another header */
+    { "$GPGGX,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", FULL, 0, 0 },
+#endif
+#if NMEA_SENTENCE_GSA
+    { "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*", FULL, 1, FIX | SATINUSE | PDOP | HDOP | VDOP },
+    { "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*", NONE, 1, FIX | SATINUSE | PDOP | HDOP | VDOP },
+    { "$GPGSA,A,,,,,,,,,,,,,,,,*", FULL, 1, 0 },
+    { "$GPGSA,A,,,,,,,,,,,,,,,,*", NONE, 1, 0 },
+    /* 16 tokens */
+    { "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3*", FULL, 0, 0 },
+    /* a fix mode and a fix type that are out of range */
+    { "$GPGSA,X,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*", FULL, 0, 0 },
+    { "$GPGSA,X,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*", STRUCTURAL, 1, FIX | SATINUSE | PDOP | HDOP | VDOP },
+    { "$GPGSA,A,4,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*", FULL, 0, 0 },
+    /* NMEA 4.10: the system ID, which must be known at every level */
+    { "$GNGSA,A,3,65,66,,,,,,,,,,,2.5,1.3,2.1,2*", FULL, 1, FIX | SATINUSE | PDOP | HDOP | VDOP },
+    { "$GNGSA,A,3,65,66,,,,,,,,,,,2.5,1.3,2.1,9*", NONE, 0, 0 },
+#endif
+#if NMEA_SENTENCE_GSV
+    { "$GPGSV,3,1,11,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*", FULL, 1, SATINVIEW },
+    { "$GPGSV,3,3,11,19,40,083,46,20,17,308,41,21,07,344,39*", FULL, 1, SATINVIEW },
+    { "$GPGSV,1,1,00*", FULL, 1, 0 },
+    { "$GPGSV,1,1,02,05,,,,07,90,000,*", FULL, 1, SATINVIEW },
+    /* a message index beyond the message count, no message count */
+    { "$GPGSV,1,2,04,05,40,083,46*", FULL, 0, 0 },
+    { "$GPGSV,,1,04,05,40,083,46*", NONE, 0, 0 },
+    /* a satellite without its signal to noise ratio field */
+    { "$GPGSV,1,1,01,05,40,083*", FULL, 0, 0 },
+    /* an azimuth that is out of range */
+    { "$GPGSV,1,1,01,05,40,360,46*", FULL, 0, 0 },
+    { "$GPGSV,1,1,01,05,40,360,46*", STRUCTURAL, 1, SATINVIEW },
+    /* NMEA 4.10: the signal ID */
+    { "$GLGSV,1,1,01,65,40,083,46,3*", FULL, 1, SATINVIEW },
+#endif
+#if NMEA_SENTENCE_RMC
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*", FULL, 1,
+        UTCTIME | UTCDATE | SIG | FIX | LAT | LON | SPEED | TRACK | MAGVAR },
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*", NONE, 1,
+        UTCTIME | UTCDATE | SIG | FIX | LAT | LON | SPEED | TRACK | MAGVAR },
+    /* without a status the fix is void */
+    { "$GPRMC,,,,,,,,,,,*", FULL, 1, SIG | FIX },
+    { "$GPRMC,,,,,,,,,,,*", NONE, 1, 0 },
+    /* 10 tokens */
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1*", FULL, 0, 0 },
+    /* a malformed time, a malformed date */
+    { "$GPRMC,1235,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*", STRUCTURAL, 0, 0 },
+    { "$GPRMC,1235,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*", NONE, 1,
+        UTCDATE | SIG | FIX | LAT | LON | SPEED | TRACK | MAGVAR },
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,-30394,003.1,W*", STRUCTURAL, 0, 0 },
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,-30394,003.1,W*", NONE, 1,
+        UTCTIME | SIG | FIX | LAT | LON | SPEED | TRACK | MAGVAR },
+    /* a date out of range */
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,320394,003.1,W*", FULL, 0, 0 },
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,320394,003.1,W*", STRUCTURAL, 1,
+        UTCTIME | UTCDATE | SIG | FIX | LAT | LON | SPEED | TRACK | MAGVAR },
+    /* a magnetic variation and a longitude without their hemispheres */
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,,022.4,084.4,230394,003.1,*", FULL, 1,
+        UTCTIME | UTCDATE | SIG | FIX | LAT | SPEED | TRACK },
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,,022.4,084.4,230394,003.1,*", NONE, 1,
+        UTCTIME | UTCDATE | SIG | FIX | LAT | SPEED | TRACK },
+    /* a status and a mode that are out of range */
+    { "$GPRMC,123519.000,X,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*", FULL, 0, 0 },
+    { "$GPRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W,X*", FULL, 0, 0 },
+#endif
+#if NMEA_SENTENCE_VTG
+    { "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*", FULL, 1, TRACK | MTRACK | SPEED },
+    { "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*", NONE, 1, TRACK | MTRACK | SPEED },
+    { "$GPVTG,054.7,T,,M,005.5,N,,K*", FULL, 1, TRACK | SPEED },
+    { "$GPVTG,,,,,,,,*", FULL, 1, 0 },
+    { "$GPVTG,,,,,,,,*", NONE, 1, 0 },
+    /* 7 tokens */
+    { "$GPVTG,054.7,T,034.4,M,005.5,N,010.2*", FULL, 0, 0 },
+    /* a unit that is out of range */
+    { "$GPVTG,054.7,X,034.4,M,005.5,N,010.2,K*", FULL, 0, 0 },
+    { "$GPVTG,054.7,X,034.4,M,005.5,N,010.2,K*", STRUCTURAL, 1, TRACK | MTRACK | SPEED },
+#endif
+};
+
+/**
+ * Decode a sentence with the decoder of its type.
+ *
+ * @param body the sentence up to and including the '*'
+ * @param validation the validation level
+ * @param packs a pointer to the sentence structures
+ * @return the return value of the decoder, 0 for an unknown sentence type
+ */
+static int decode(const char *body, const enum nmeaVALIDATION validation, PACKS *packs) {
+  char buf[128];
+  int len = test_sentence(buf, body);
+  nmeaFIELDS fields;
+
+  nmea_parse_fields(buf, len, &fields);
+  switch (nmea_parse_get_sentence_type(&buf[1], len - 1)) {
+#if NMEA_SENTENCE_GGA
+    case GPGGA:
+      return nmea_parse_GPGGA_fields(buf, len, &fields, validation, &packs->gga);
+#endif
+#if NMEA_SENTENCE_GSA
+    case GPGSA:
+      return nmea_parse_GPGSA_fields(buf, len, &fields, validation, &packs->gsa);
+#endif
+#if NMEA_SENTENCE_GSV
+    case GPGSV:
+      return nmea_parse_GPGSV_fields(buf, len, &fields, validation, &packs->gsv);
+#endif
+#if NMEA_SENTENCE_RMC
+    case GPRMC:
+      return nmea_parse_GPRMC_fields(buf, len, &fields, validation, &packs->rmc);
+#endif
+#if NMEA_SENTENCE_VTG
+    case GPVTG:
+      return nmea_parse_GPVTG_fields(buf, len, &fields, validation, &packs->vtg);
+#endif
+    default:
+      return 0;
+  }
+}
+
+#if NMEA_SENTENCE_GGA
+static void test_gga(void) {
+  PACKS packs;
+  const nmeaGPGGA *pack = &packs.gga;
+
+  CHECK(decode("$GPGGA,123519.123,4807.038,S,01131.000,W,2,08,0.9,-12.5,M,46.9,M,1.5,0042*", FULL, &packs));
+  CHECK((pack->utc.hour == 12) && (pack->utc.min == 35) && (pack->utc.sec == 19) && (pack->utc.hsec == 13));
+  CHECK_NEAR(TEST_NDEG(pack->lat), 4807.038, TEST_NDEG_TOLERANCE);
+  CHECK(pack->ns == 'S');
+  CHECK_NEAR(TEST_NDEG(pack->lon), 1131.0, TEST_NDEG_TOLERANCE);
+  CHECK(pack->ew == 'W');
+  CHECK(pack->sig == 2);
+  CHECK(pack->satinuse == 8);
+  CHECK_NEAR(TEST_VALUE(pack->HDOP, NMEA_DOP_SCALE), 0.9, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_VALUE(pack->elv, NMEA_LENGTH_SCALE), -12.5, TEST_TOLERANCE);
+  CHECK(pack->elv_units == 'M');
+  CHECK_NEAR(TEST_VALUE(pack->diff, NMEA_LENGTH_SCALE), 46.9, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_VALUE(pack->dgps_age, NMEA_DURATION_SCALE), 1.5, TEST_TOLERANCE);
+  CHECK(pack->dgps_sid == 42);
+
+  /* full validation marks the absent fields */
+  CHECK(decode("$GPGGA,,,,,,,,,,,,,,*", FULL, &packs));
+  CHECK((pack->utc.hour == -1) && (pack->sig == -1) && (pack->satinuse == -1));
+  CHECK(TEST_NONE(pack->lat) && TEST_NONE(pack->lon) && TEST_NONE(pack->HDOP) && TEST_NONE(pack->elv));
+  CHECK(!pack->ns && !pack->ew && !pack->elv_units);
+}
+#endif
+
+#if NMEA_SENTENCE_GSA
+static void test_gsa(void) {
+  static const int prns[NMEA_SATINGSA] = { 4, 5, 0, 9, 12, 0, 0, 24, 0, 0, 0, 0 };
+  PACKS packs;
+  const nmeaGPGSA *pack = &packs.gsa;
+
+  CHECK(decode("$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*", FULL, &packs));
+  CHECK(pack->fix_mode == 'A');
+  CHECK(pack->fix_type == 3);
+  CHECK(!memcmp(pack->sat_prn, prns, sizeof(prns)));
+  CHECK_NEAR(TEST_VALUE(pack->PDOP, NMEA_DOP_SCALE), 2.5, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_VALUE(pack->HDOP, NMEA_DOP_SCALE), 1.3, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_VALUE(pack->VDOP, NMEA_DOP_SCALE), 2.1, TEST_TOLERANCE);
+  CHECK(pack->system == SYSTEM_GPS);
+
+  /* the system of a GN sentence is its system ID, or unknown without it */
+  CHECK(decode("$GNGSA,A,3,65,66,,,,,,,,,,,2.5,1.3,2.1,2*", FULL, &packs));
+  CHECK(pack->system == SYSTEM_GLONASS);
+  CHECK((pack->sat_prn[0] == 65) && (pack->sat_prn[1] == 66));
+  CHECK(decode("$GNGSA,A,3,65,66,,,,,,,,,,,2.5,1.3,2.1*", FULL, &packs));
+  CHECK(pack->system == SYSTEM_UNKNOWN);
+
+  CHECK(decode("$GPGSA,A,,,,,,,,,,,,,,,,*", FULL, &packs));
+  CHECK(pack->fix_type == -1);
+  CHECK(TEST_NONE(pack->PDOP) && TEST_NONE(pack->HDOP) && TEST_NONE(pack->VDOP));
+}
+#endif
+
+#if NMEA_SENTENCE_GSV
+static void test_gsv(void) {
+  PACKS packs;
+  const nmeaGPGSV *pack = &packs.gsv;
+
+  CHECK(decode("$GPGSV,3,1,11,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*", FULL, &packs));
+  CHECK((pack->pack_count == 3) && (pack->pack_index == 1) && (pack->sat_count == 11));
+  CHECK((pack->sat_data[0].id == 1) && (pack->sat_data[0].elv == 40) && (pack->sat_data[0].azimuth == 83)
+      && (pack->sat_data[0].sig == 46));
+  CHECK((pack->sat_data[3].id == 14) && (pack->sat_data[3].elv == 22) && (pack->sat_data[3].azimuth == 228)
+      && (pack->sat_data[3].sig == 45));
+  CHECK((pack->system == SYSTEM_GPS) && (pack->sat_data[0].system == SYSTEM_GPS) && !pack->signal);
+
+  /* the last message of a cycle holds the remaining satellites */
+  CHECK(decode("$GPGSV,3,3,11,19,40,083,46,20,17,308,41,21,07,344,39*", FULL, &packs));
+  CHECK((pack->sat_data[2].id == 21) && !pack->sat_data[3].id);
+
+  /* a satellite that is not tracked has no signal to noise ratio */
+  CHECK(decode("$GPGSV,1,1,02,05,,,,07,90,000,*", FULL, &packs));
+  CHECK((pack->sat_data[0].id == 5) && !pack->sat_data[0].elv && !pack->sat_data[0].sig);
+  CHECK((pack->sat_data[1].id == 7) && (pack->sat_data[1].elv == 90) && !pack->sat_data[1].sig);
+
+  /* NMEA 4.10: the signal ID follows the satellites */
+  CHECK(decode("$GLGSV,1,1,01,65,40,083,46,3*", FULL, &packs));
+  CHECK((pack->system == SYSTEM_GLONASS) && (pack->signal == 3));
+  CHECK((pack->sat_data[0].id == 65) && (pack->sat_data[0].signal == 3) && (pack->sat_data[0].sig == 46));
+}
+#endif
+
+#if NMEA_SENTENCE_RMC
+static void test_rmc(void) {
+  PACKS packs;
+  const nmeaGPRMC *pack = &packs.rmc;
+
+  CHECK(decode("$GPRMC,123519.456,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*", FULL, &packs));
+  CHECK((pack->utc.hour == 12) && (pack->utc.min == 35) && (pack->utc.sec == 19) && (pack->utc.hsec == 46));
+  CHECK((pack->utc.year == 94) && (pack->utc.mon == 2) && (pack->utc.day == 23));
+  CHECK(pack->status == 'A');
+  CHECK_NEAR(TEST_NDEG(pack->lat), 4807.038, TEST_NDEG_TOLERANCE);
+  CHECK((pack->ns == 'N') && (pack->ew == 'E'));
+  CHECK_NEAR(TEST_NDEG(pack->lon), 1131.0, TEST_NDEG_TOLERANCE);
+  CHECK_NEAR(TEST_KNOTS(pack->speed), 22.4, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_VALUE(pack->track, NMEA_ANGLE_SCALE), 84.4, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_VALUE(pack->magvar, NMEA_ANGLE_SCALE), 3.1, TEST_TOLERANCE);
+  CHECK(pack->magvar_ew == 'W');
+  /* the mode of NMEA 2.3 is 'A' for the sentences before */
+  CHECK(pack->mode == 'A');
+
+  /* the years before 90 are in the 21st century */
+  CHECK(decode("$GPRMC,000000.000,V,,,,,,,010189,,,N*", FULL, &packs));
+  CHECK((pack->utc.year == 189) && (pack->utc.mon == 0) && (pack->utc.day == 1));
+  CHECK((pack->status == 'V') && (pack->mode == 'N'));
+
+  CHECK(decode("$GPRMC,,,,,,,,,,,,*", FULL, &packs));
+  CHECK((pack->utc.year == -1) && (pack->utc.hour == -1));
+  CHECK(TEST_NONE(pack->lat) && TEST_NONE(pack->lon) && TEST_NONE(pack->speed) && TEST_NONE(pack->track)
+      && TEST_NONE(pack->magvar));
+  CHECK((pack->status == 'V') && (pack->mode == 'N'));
+}
+#endif
+
+#if NMEA_SENTENCE_VTG
+static void test_vtg(void) {
+  PACKS packs;
+  const nmeaGPVTG *pack = &packs.vtg;
+
+  CHECK(decode("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*", FULL, &packs));
+  CHECK_NEAR(TEST_VALUE(pack->track, NMEA_ANGLE_SCALE), 54.7, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_VALUE(pack->mtrack, NMEA_ANGLE_SCALE), 34.4, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_KNOTS(pack->spn), 5.5, TEST_TOLERANCE);
+  CHECK_NEAR(TEST_KPH(pack->spk), 10.2, TEST_TOLERANCE);
+  CHECK((pack->track_t == 'T') && (pack->mtrack_m == 'M') && (pack->spn_n == 'N') && (pack->spk_k == 'K'));
+
+  /* the speed that is missing follows from the other one, at every level */
+  CHECK(decode("$GPVTG,054.7,T,,M,005.5,N,,K*", FULL, &packs));
+  CHECK_NEAR(TEST_KPH(pack->spk), 5.5 * 1.852, TEST_TOLERANCE);
+  CHECK(TEST_NONE(pack->mtrack));
+  CHECK(decode("$GPVTG,054.7,T,,M,,N,010.2,K*", NONE, &packs));
+  CHECK_NEAR(TEST_KNOTS(pack->spn), 10.2 / 1.852, TEST_TOLERANCE);
+}
+#endif
+
+int main(void) {
+  size_t i;
+
+  for (i = 0; i < (sizeof(decodes) / sizeof(decodes[0])); i++) {
+    const DECODE *d = &decodes[i];
+    PACKS packs;
+    int parsed = decode(d->body, d->validation, &packs);
+
+    if ((parsed != d->parsed) || (parsed && (packs.present != d->present))) {
+      printf("%s (validation %d): %d, present %05x, expected %d, present %05x: FAILED\n", d->body, d->validation,
+          parsed, packs.present, d->parsed, d->present);
+      test_failures++;
+    }
+  }
+
+#if NMEA_SENTENCE_GGA
+  test_gga();
+#endif
+#if NMEA_SENTENCE_GSA
+  test_gsa();
+#endif
+#if NMEA_SENTENCE_GSV
+  test_gsv();
+#endif
+#if NMEA_SENTENCE_RMC
+  test_rmc();
+#endif
+#if NMEA_SENTENCE_VTG
+  test_vtg();
+#endif
+
+  printf("decoders: %d sentences, %s\n", (int) (sizeof(decodes) / sizeof(decodes[0])),
+      test_failures ? "FAILED" : "ok");
+  return TEST_RESULT;
+}
@@ -0,0 +1,167 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Merge test: parses a mixed set of sentences (empty fields, garbage, other
+ * talkers, NMEA 4.10 fields) one after the other into a single nmeaINFO and
+ * checks the merged fields after each of them. A second parser merges the
+ * same sentences through nmea_parser_info_callback, which must give the same
+ * information.
+ */
+
+#include "test.h"
+
+#include <nmea/parser.h>
+
+#if NMEA_SENTENCE_GGA && NMEA_SENTENCE_GSA && NMEA_SENTENCE_GSV && NMEA_SENTENCE_RMC && NMEA_SENTENCE_VTG
+/**
+ * A sentence and the merged nmeaINFO fields after it
+ */
+typedef struct _MERGE {
+  const char *sentences;  /**< The sentences, the checksums are completed by the test */
+  int parsed;             /**< The number of sentences that are parsed */
+  uint32_t present;       /**< The present mask */
+  int sec;                /**< The seconds of the time */
+  int hsec;               /**< The hundredths of seconds of the time */
+  int sig;                /**< The signal quality */
+  int fix;                /**< The fix type */
+  double lat;             /**< The latitude in NDEG */
+  double lon;             /**< The longitude in NDEG */
+  double elv;             /**< The altitude in meters */
+  double speed;           /**< The speed in kph */
+  double magvar;          /**< The magnetic variation in degrees */
+  int inuse;              /**< The number of satellites in use */
+  int inview;             /**< The number of satellites in view */
+} MERGE;
+
+static const MERGE merges[] = {
+    { "$GPGGA,123519.123,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*",
+        1, 0x0874d, 19, 13, 1, 0, 4807.038, 1131.0, 545.4, 0.0, 0.0, 8, 0 },
+    { "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*",
+        1, 0x187fd, 19, 13, 1, 3, 4807.038, 1131.0, 545.4, 0.0, 0.0, 5, 0 },
+    /* the satellites in view are merged when the cycle is complete */
+    { "$GPGSV,3,1,11,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*",
+        1, 0x187fd, 19, 13, 1, 3, 4807.038, 1131.0, 545.4, 0.0, 0.0, 5, 0 },
+    { "$GPGSV,3,2,11,15,40,083,46,16,17,308,41,17,07,344,39,18,22,228,45*",
+        1, 0x187fd, 19, 13, 1, 3, 4807.038, 1131.0, 545.4, 0.0, 0.0, 5, 0 },
+    { "$GPGSV,3,3,11,19,40,083,46,20,17,308,41,21,07,344,39*",
+        1, 0x387fd, 19, 13, 1, 3, 4807.038, 1131.0, 545.4, 0.0, 0.0, 5, 11 },
+    { "$GPRMC,123519.456,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*",
+        1, 0x3dfff, 19, 46, 1, 3, 4807.038, 1131.0, 545.4, 41.4848, -3.1, 5, 11 },
+    { "$GPRMC,123520.000,A,4807.038,S,01131.000,W,022.4,084.4,230394,003.1,E,D*",
+        1, 0x3dfff, 20, 0, 1, 3, -4807.038, -1131.0, 545.4, 41.4848, 3.1, 5, 11 },
+    { "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*",
+        1, 0x3ffff, 20, 0, 1, 3, -4807.038, -1131.0, 545.4, 10.2, 3.1, 5, 11 },
+    /* the speed in kph is derived from the speed in knots */
+    { "$GPVTG,054.7,T,,M,005.5,N,,K*",
+        1, 0x3ffff, 20, 0, 1, 3, -4807.038, -1131.0, 545.4, 10.186, 3.1, 5, 11 },
+    /* empty fields keep the merged values */
+    { "$GPGGA,,,,,,0,,,,,,,,*",
+        1, 0x3ffff, 20, 0, 0, 3, -4807.038, -1131.0, 545.4, 10.186, 3.1, 5, 11 },
+    { "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,-12.5,M,46.9,M,,*",
+        1, 0x3ffff, 19, 0, 1, 3, 4807.038, 1131.0, -12.5, 10.186, 3.1, 8, 11 },
+    { "$GPRMC,,V,,,,,,,,,,N*",
+        1, 0x3ffff, 19, 0, 0, 1, 4807.038, 1131.0, -12.5, 10.186, 3.1, 8, 11 },
+    { "$GPGSA,A,1,,,,,,,,,,,,,,,*",
+        1, 0x3ffff, 19, 0, 0, 1, 4807.038, 1131.0, -12.5, 10.186, 3.1, 8, 11 },
+    /* garbage, then a signal quality that is out of range */
+    { "garbage$GPGGA,12\r\n$GPGGA,123519.000,4807.038,N,01131.000,E,9,08,0.9,545.4,M,46.9,M,,*",
+        0, 0x3ffff, 19, 0, 0, 1, 4807.038, 1131.0, -12.5, 10.186, 3.1, 8, 11 },
+    { "$GPGSV,1,1,02,05,-10,350,,07,90,000,00*",
+        1, 0x3ffff, 19, 0, 0, 1, 4807.038, 1131.0, -12.5, 10.186, 3.1, 8, 2 },
+    /* an unknown sentence, then another talker */
+    { "$GPXXX,1,2,3*00\r\n$GNGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*",
+        1, 0x3ffff, 19, 0, 1, 1, 4807.038, 1131.0, 545.4, 10.186, 3.1, 8, 2 },
+    /* NMEA 4.10: the mode and the navigational status */
+    { "$GPRMC,123519.456,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W,A,V*",
+        1, 0x3ffff, 19, 46, 1, 2, 4807.038, 1131.0, 545.4, 41.4848, -3.1, 8, 2 }
+};
+
+int main(void) {
+  nmeaPARSER parser;
+  nmeaPARSER callback_parser;
+  nmeaINFO info;
+  nmeaINFO callback_info;
+  nmeaINFOMERGE merge;
+  int failures;
+  int type;
+  size_t i;
+
+  nmea_parser_init(&parser);
+  memset(&info, 0, sizeof(info));
+
+  nmea_parser_init(&callback_parser);
+  memset(&callback_info, 0, sizeof(callback_info));
+  nmea_parser_info_merge_init(&merge, &callback_info);
+  for (type = GPGGA; type <= GPVTG; type <<= 1) {
+    nmea_parser_set_callback(&callback_parser, (enum nmeaPACKTYPE) type, nmea_parser_info_callback, &merge);
+  }
+
+  for (i = 0; i < (sizeof(merges) / sizeof(merges[0])); i++) {
+    const MERGE *m = &merges[i];
+    char buf[256];
+    const char *last = strrchr(m->sentences, '$');
+    int len = (int) (last - m->sentences);
+
+    /* the sentences before the last one keep their own checksums */
+    memcpy(buf, m->sentences, (size_t) len);
+    len += test_sentence(&buf[len], last);
+
+    failures = test_failures;
+    CHECK(nmea_parse(&parser, buf, len, &info) == m->parsed);
+    CHECK(info.present == m->present);
+    CHECK(info.utc.sec == m->sec);
+    CHECK(info.utc.hsec == m->hsec);
+    CHECK(info.sig == m->sig);
+    CHECK(info.fix == m->fix);
+    CHECK_NEAR(TEST_NDEG(info.lat), m->lat, TEST_NDEG_TOLERANCE);
+    CHECK_NEAR(TEST_NDEG(info.lon), m->lon, TEST_NDEG_TOLERANCE);
+    CHECK_NEAR(TEST_VALUE(info.elv, NMEA_LENGTH_SCALE), m->elv, TEST_TOLERANCE);
+    CHECK_NEAR(TEST_KPH(info.speed), m->speed, TEST_TOLERANCE);
+    CHECK_NEAR(TEST_VALUE(info.magvar, NMEA_ANGLE_SCALE), m->magvar, TEST_TOLERANCE);
+    CHECK(info.satinfo.inuse == m->inuse);
+    CHECK(info.satinfo.inview == m->inview);
+
+    CHECK(nmea_parse(&callback_parser, buf, len, NULL) == m->parsed);
+    CHECK(callback_info.present == info.present);
+    CHECK(!memcmp(&callback_info.utc, &info.utc, sizeof(info.utc)));
+    CHECK((callback_info.sig == info.sig) && (callback_info.fix == info.fix));
+    CHECK(!memcmp(&callback_info.lat, &info.lat, sizeof(info.lat)));
+    CHECK(!memcmp(&callback_info.speed, &info.speed, sizeof(info.speed)));
+    CHECK(!memcmp(callback_info.satinfo.in_use, info.satinfo.in_use, sizeof(info.satinfo.in_use)));
+    CHECK(callback_info.satinfo.inview == info.satinfo.inview);
+    CHECK(!memcmp(callback_info.satinfo.sat, info.satinfo.sat, sizeof(info.satinfo.sat)));
+    if (test_failures != failures) {
+      printf("after %s", &buf[last - m->sentences]);
+    }
+  }
+
+  /* the satellites of the last GSV cycle */
+  CHECK((info.satinfo.sat[0].id == 5) && (info.satinfo.sat[0].elv == -10) && (info.satinfo.sat[0].azimuth == 350));
+  CHECK((info.satinfo.sat[1].id == 7) && (info.satinfo.sat[1].elv == 90) && !info.satinfo.sat[1].sig);
+  CHECK(!info.satinfo.sat[2].id);
+
+  printf("merge: %s\n", test_failures ? "FAILED" : "ok");
+  return TEST_RESULT;
+}
+#else
+int main(void) {
+  printf("merge: skipped, needs all the sentences\n");
+  return TEST_RESULT;
+}
+#endif
@@ -0,0 +1,155 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Two-thread test of the character ring: a producer thread writes numbered
+ * GGA sentences into the ring in chunks of random sizes while the parsing
+ * thread parses them with nmea_parse_ring. Checks that the sentences arrive
+ * complete and in order, first with a producer that retries the characters
+ * that did not fit (nothing may be lost), then with one that drops them
+ * (the sentences that arrive must still be in order).
+ */
+
+#include <nmea/ring.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if NMEA_SENTENCE_GGA
+#define SENTENCES 200000
+
+static nmeaRING ring;
+static atomic_bool done;
+static bool retry;
+
+static int received;
+static int last;
+static int disorder;
+
+/**
+ * Format the numbered sentence, the number is the DGPS station ID
+ */
+static int sentence(char *buf, const int number) {
+  int len = sprintf(buf, "$GPGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,%d*", number);
+  unsigned char checksum = 0;
+  int i;
+
+  for (i = 1; i < (len - 1); i++) {
+    checksum ^= (unsigned char) buf[i];
+  }
+
+  return len + sprintf(&buf[len], "%02X\r\n", checksum);
+}
+
+static void *producer(void *arg) {
+  unsigned int seed = 1;
+  char buf[128];
+  int number;
+
+  (void) arg;
+
+  for (number = 1; number <= SENTENCES; number++) {
+    int len = sentence(buf, number);
+    int written = 0;
+
+    while (written < len) {
+      size_t chunk = 1 + (size_t) (rand_r(&seed) % (len - written));
+      size_t fit = nmea_ring_write(&ring, &buf[written], chunk);
+
+      if (!retry) {
+        /* the characters that did not fit are dropped */
+        written += (int) chunk;
+      } else {
+        written += (int) fit;
+        if (fit < chunk) {
+          sched_yield();
+        }
+      }
+    }
+
+    /* let the parsing thread in on a single CPU */
+    if (!(number % 16)) {
+      sched_yield();
+    }
+  }
+
+  atomic_store(&done, true);
+  return NULL;
+}
+
+static void gga(const enum nmeaPACKTYPE type, const void *pack, const char *s, const int len, void *arg) {
+  int number = ((const nmeaGPGGA *) pack)->dgps_sid;
+
+  (void) type;
+  (void) s;
+  (void) len;
+  (void) arg;
+
+  if (number <= last) {
+    disorder++;
+  }
+  last = number;
+  received++;
+}
+
+static bool run(const bool retrying) {
+  nmeaPARSER parser;
+  pthread_t thread;
+  unsigned int overruns;
+  unsigned int dropped;
+  bool ok;
+
+  nmea_ring_init(&ring);
+  nmea_parser_init(&parser);
+  nmea_parser_set_callback(&parser, GPGGA, gga, NULL);
+  atomic_store(&done, false);
+  retry = retrying;
+  received = 0;
+  last = 0;
+  disorder = 0;
+
+  pthread_create(&thread, NULL, producer, NULL);
+  while (!atomic_load(&done)) {
+    nmea_parse_ring(&parser, &ring, NULL);
+    sched_yield();
+  }
+  nmea_parse_ring(&parser, &ring, NULL);
+  pthread_join(thread, NULL);
+
+  nmea_ring_counters(&ring, &overruns, &dropped);
+  ok = !disorder && (retrying ? (received == SENTENCES) : (received <= SENTENCES));
+  printf("%s producer: %d of %d sentences, %d out of order, %u overruns, %u characters refused: %s\n",
+      retrying ? "retrying" : "dropping", received, SENTENCES, disorder, overruns, dropped, ok ? "ok" : "FAILED");
+  return ok;
+}
+
+int main(void) {
+  bool ok = run(true);
+
+  ok = run(false) && ok;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#else
+int main(void) {
+  printf("ring: skipped, needs GGA\n");
+  return EXIT_SUCCESS;
+}
+#endif
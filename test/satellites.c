@@ -0,0 +1,239 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Satellite store test: adds, updates and finds satellites in view (several
+ * signals of a satellite share their slot in the index), fills the store,
+ * marks and sweeps the satellites of a system and signal, and replaces the
+ * satellites in use per system, as the GN GSA sentences without a system ID
+ * do by the PRN ranges.
+ */
+
+#include "test.h"
+
+#include <nmea/info.h>
+
+/**
+ * Add or update a satellite in view
+ */
+static bool update(nmeaINFO *info, const int system, const int id, const int signal, const int sig) {
+  nmeaSATELLITE sat;
+
+  memset(&sat, 0, sizeof(sat));
+  sat.system = system;
+  sat.id = id;
+  sat.signal = signal;
+  sat.elv = id % 90;
+  sat.azimuth = (id * 7) % 360;
+  sat.sig = sig;
+  return nmea_INFO_sat_update(&info->satinfo, &sat);
+}
+
+/**
+ * Determine whether the satellites in view are exactly the ones that can be found
+ */
+static bool consistent(nmeaINFO *info) {
+  int entry;
+
+  for (entry = 0; entry < info->satinfo.inview; entry++) {
+    const nmeaSATELLITE *sat = &info->satinfo.sat[entry];
+
+    if (nmea_INFO_sat_find(&info->satinfo, sat->system, sat->id, sat->signal) != sat) {
+      return false;
+    }
+  }
+  for (; entry < NMEA_MAXSAT; entry++) {
+    if (info->satinfo.sat[entry].id) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void test_update(void) {
+  nmeaINFO info;
+  nmeaSATELLITE *sat;
+
+  memset(&info, 0, sizeof(info));
+  CHECK(update(&info, SYSTEM_GPS, 5, 0, 40));
+  CHECK(update(&info, SYSTEM_GLONASS, 5, 0, 30));
+  CHECK(update(&info, SYSTEM_GPS, 12, 0, 20));
+  CHECK(info.satinfo.inview == 3);
+  CHECK(nmea_INFO_sat_is_changed(&info.satinfo, 0) && nmea_INFO_sat_is_changed(&info.satinfo, 2));
+
+  /* the same PRN of another system is another satellite */
+  sat = nmea_INFO_sat_find(&info.satinfo, SYSTEM_GLONASS, 5, 0);
+  CHECK(sat && (sat == &info.satinfo.sat[1]) && (sat->sig == 30));
+  CHECK(!nmea_INFO_sat_find(&info.satinfo, SYSTEM_GALILEO, 5, -1));
+
+  /* an unchanged update does not change the entry, a changed one does */
+  nmea_INFO_clear_changed(&info);
+  CHECK(update(&info, SYSTEM_GPS, 5, 0, 40));
+  CHECK(!nmea_INFO_sat_is_changed(&info.satinfo, 0));
+  CHECK(update(&info, SYSTEM_GPS, 5, 0, 41));
+  CHECK(nmea_INFO_sat_is_changed(&info.satinfo, 0) && !nmea_INFO_sat_is_changed(&info.satinfo, 1));
+  CHECK((info.satinfo.inview == 3) && (info.satinfo.sat[0].sig == 41));
+
+  /* the signals of a satellite collide in the index, each is found */
+  CHECK(update(&info, SYSTEM_GPS, 5, 1, 35));
+  CHECK(update(&info, SYSTEM_GPS, 5, 7, 25));
+  CHECK(info.satinfo.inview == 5);
+  CHECK(nmea_INFO_sat_find(&info.satinfo, SYSTEM_GPS, 5, 1) == &info.satinfo.sat[3]);
+  CHECK(nmea_INFO_sat_find(&info.satinfo, SYSTEM_GPS, 5, 7) == &info.satinfo.sat[4]);
+  CHECK(nmea_INFO_sat_find(&info.satinfo, SYSTEM_GPS, 5, -1) == &info.satinfo.sat[0]);
+  CHECK(!nmea_INFO_sat_find(&info.satinfo, SYSTEM_GPS, 5, 2));
+  CHECK(consistent(&info));
+}
+
+static void test_full(void) {
+  nmeaINFO info;
+  int i;
+
+  /* PRNs close together, so that the probe sequences overlap */
+  memset(&info, 0, sizeof(info));
+  for (i = 0; i < NMEA_MAXSAT; i++) {
+    CHECK(update(&info, (i % 2) ? SYSTEM_GPS : SYSTEM_BEIDOU, 1 + (i / 2), 0, i));
+  }
+  CHECK(info.satinfo.inview == NMEA_MAXSAT);
+  CHECK(consistent(&info));
+
+  /* a new satellite does not fit, an update of a stored one does */
+  CHECK(!update(&info, SYSTEM_GALILEO, 1, 0, 10));
+  CHECK(!nmea_INFO_sat_find(&info.satinfo, SYSTEM_GALILEO, 1, -1));
+  CHECK(update(&info, SYSTEM_GPS, 1, 0, 99));
+  CHECK((info.satinfo.inview == NMEA_MAXSAT) && (info.satinfo.sat[1].sig == 99));
+}
+
+static void test_sweep(void) {
+  nmeaINFO info;
+  int i;
+
+  memset(&info, 0, sizeof(info));
+  for (i = 1; i <= 8; i++) {
+    CHECK(update(&info, SYSTEM_GPS, i, 0, 40));
+    CHECK(update(&info, SYSTEM_GLONASS, 64 + i, 0, 30));
+  }
+  CHECK(update(&info, SYSTEM_GPS, 3, 5, 20));
+
+  /* a cycle of the GPS satellites of signal 0 reports the odd PRNs and a new one */
+  nmea_INFO_sat_mark(&info.satinfo, SYSTEM_GPS, 0);
+  for (i = 1; i <= 8; i += 2) {
+    CHECK(update(&info, SYSTEM_GPS, i, 0, 40));
+  }
+  CHECK(update(&info, SYSTEM_GPS, 9, 0, 40));
+
+  /* the satellites stay in view during the cycle */
+  CHECK(info.satinfo.inview == 18);
+  CHECK(nmea_INFO_sat_find(&info.satinfo, SYSTEM_GPS, 2, 0));
+
+  nmea_INFO_clear_changed(&info);
+  nmea_INFO_sat_sweep(&info.satinfo, SYSTEM_GPS, 0);
+  CHECK(info.satinfo.inview == 14);
+  for (i = 1; i <= 9; i++) {
+    CHECK(!nmea_INFO_sat_find(&info.satinfo, SYSTEM_GPS, i, 0) == !(i % 2));
+    CHECK(nmea_INFO_sat_find(&info.satinfo, SYSTEM_GLONASS, 64 + i, 0) || (i == 9));
+  }
+
+  /* the other signals and systems are kept, the entries that moved changed */
+  CHECK(nmea_INFO_sat_find(&info.satinfo, SYSTEM_GPS, 3, 5));
+  CHECK(!nmea_INFO_sat_is_changed(&info.satinfo, 0) && nmea_INFO_sat_is_changed(&info.satinfo, 2));
+  CHECK(nmea_INFO_sat_is_changed(&info.satinfo, 17));
+  CHECK(consistent(&info));
+
+  /* a sweep without a mark keeps all */
+  nmea_INFO_sat_sweep(&info.satinfo, SYSTEM_GLONASS, 0);
+  CHECK(info.satinfo.inview == 14);
+
+  /* a cycle that reports nothing removes all of its satellites */
+  nmea_INFO_sat_mark(&info.satinfo, SYSTEM_GLONASS, 0);
+  nmea_INFO_sat_sweep(&info.satinfo, SYSTEM_GLONASS, 0);
+  CHECK(info.satinfo.inview == 6);
+  CHECK(consistent(&info));
+}
+
+/**
+ * Determine whether the satellites in use are the given ones, in order
+ */
+static bool in_use(const nmeaINFO *info, const nmeaSATID *ids, const int count) {
+  int i;
+
+  if (info->satinfo.inuse != count) {
+    return false;
+  }
+  for (i = 0; i < NMEA_MAXSAT; i++) {
+    const nmeaSATID none = { 0, 0 };
+    const nmeaSATID *id = (i < count) ? &ids[i] : &none;
+
+    if ((info->satinfo.in_use[i].system != id->system) || (info->satinfo.in_use[i].id != id->id)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void test_use(void) {
+  static const int gps[NMEA_SATINGSA] = { 4, 5, 0, 9 };
+  static const int galileo[NMEA_SATINGSA] = { 1, 2 };
+  static const int gn_glonass[NMEA_SATINGSA] = { 65, 0, 66 };
+  static const int gn_both[NMEA_SATINGSA] = { 7, 70 };
+  static const int gn_gps[NMEA_SATINGSA] = { 12 };
+  static const int none[NMEA_SATINGSA] = { 0 };
+  static const nmeaSATID used1[] = { { SYSTEM_GPS, 4 }, { SYSTEM_GPS, 5 }, { SYSTEM_GPS, 9 } };
+  static const nmeaSATID used2[] = { { SYSTEM_GPS, 4 }, { SYSTEM_GPS, 5 }, { SYSTEM_GPS, 9 }, { SYSTEM_GALILEO, 1 },
+      { SYSTEM_GALILEO, 2 } };
+  static const nmeaSATID used3[] = { { SYSTEM_GPS, 4 }, { SYSTEM_GPS, 5 }, { SYSTEM_GPS, 9 }, { SYSTEM_GALILEO, 1 },
+      { SYSTEM_GALILEO, 2 }, { SYSTEM_GLONASS, 65 }, { SYSTEM_GLONASS, 66 } };
+  static const nmeaSATID used4[] = { { SYSTEM_GALILEO, 1 }, { SYSTEM_GALILEO, 2 }, { SYSTEM_GPS, 7 },
+      { SYSTEM_GLONASS, 70 } };
+  static const nmeaSATID used5[] = { { SYSTEM_GALILEO, 1 }, { SYSTEM_GALILEO, 2 }, { SYSTEM_GLONASS, 70 },
+      { SYSTEM_GPS, 12 } };
+  nmeaINFO info;
+
+  memset(&info, 0, sizeof(info));
+  CHECK(nmea_INFO_sat_use(&info.satinfo, SYSTEM_GPS, gps, NMEA_SATINGSA));
+  CHECK(in_use(&info, used1, 3));
+
+  /* another system is added */
+  CHECK(nmea_INFO_sat_use(&info.satinfo, SYSTEM_GALILEO, galileo, NMEA_SATINGSA));
+  CHECK(in_use(&info, used2, 5));
+
+  /* GN without a system ID: 65-96 are GLONASS, the others GPS, only those systems are replaced */
+  CHECK(nmea_INFO_sat_use(&info.satinfo, SYSTEM_UNKNOWN, gn_glonass, NMEA_SATINGSA));
+  CHECK(in_use(&info, used3, 7));
+  CHECK(nmea_INFO_sat_use(&info.satinfo, SYSTEM_UNKNOWN, gn_both, NMEA_SATINGSA));
+  CHECK(in_use(&info, used4, 4));
+  CHECK(nmea_INFO_sat_use(&info.satinfo, SYSTEM_UNKNOWN, gn_gps, NMEA_SATINGSA));
+  CHECK(in_use(&info, used5, 4));
+
+  /* the same satellites again, and none, do not change anything */
+  CHECK(!nmea_INFO_sat_use(&info.satinfo, SYSTEM_UNKNOWN, gn_gps, NMEA_SATINGSA));
+  CHECK(!nmea_INFO_sat_use(&info.satinfo, SYSTEM_UNKNOWN, none, NMEA_SATINGSA));
+  CHECK(in_use(&info, used5, 4));
+}
+
+int main(void) {
+  test_update();
+  test_full();
+  test_sweep();
+  test_use();
+
+  printf("satellites: %s\n", test_failures ? "FAILED" : "ok");
+  return TEST_RESULT;
+}
@@ -0,0 +1,167 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Stress test of the snapshot publication: one writer thread publishes
+ * nmeaINFO structures whose words all hold the publication number while
+ * several reader threads copy them. Checks that no copy is torn (all its words
+ * hold the publication number that nmea_snapshot_read returns) and that the
+ * publication number a reader sees never decreases.
+ */
+
+#include <nmea/snapshot.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PUBLICATIONS 1000000
+#define READERS 4
+
+static nmeaSNAPSHOT snapshot;
+static atomic_bool done;
+
+typedef struct _reader {
+  pthread_t thread;
+  unsigned int reads;
+  unsigned int torn;
+  unsigned int backwards;
+} reader;
+
+/**
+ * Fill all the words of the structure with the publication number
+ */
+static void pattern(nmeaINFO *info, const uint32_t number) {
+  size_t word;
+
+  for (word = 0; word < NMEA_SNAPSHOT_WORDS; word++) {
+    memcpy((char *) info + (word * sizeof(number)), &number, sizeof(number));
+  }
+}
+
+/**
+ * Check that all the words of the structure hold the publication number
+ */
+static bool consistent(const nmeaINFO *info, const uint32_t number) {
+  size_t word;
+
+  for (word = 0; word < NMEA_SNAPSHOT_WORDS; word++) {
+    uint32_t value;
+
+    memcpy(&value, (const char *) info + (word * sizeof(value)), sizeof(value));
+    if (value != number) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void *writer(void *arg) {
+  nmeaINFO info;
+  uint32_t number;
+
+  (void) arg;
+
+  for (number = 1; number <= PUBLICATIONS; number++) {
+    pattern(&info, number);
+    nmea_snapshot_publish(&snapshot, &info);
+
+    /* let the readers in on a single CPU */
+    if (!(number % 64)) {
+      sched_yield();
+    }
+  }
+
+  atomic_store(&done, true);
+  return NULL;
+}
+
+static void *read_loop(void *arg) {
+  reader *r = (reader *) arg;
+  unsigned int last = 0;
+  bool finished;
+
+  do {
+    nmeaINFO info;
+    unsigned int version;
+
+    finished = atomic_load(&done);
+    version = nmea_snapshot_read(&snapshot, &info);
+    if (!version) {
+      continue;
+    }
+
+    r->reads++;
+    if (!consistent(&info, version)) {
+      r->torn++;
+    }
+    if (version < last) {
+      r->backwards++;
+    }
+    last = version;
+
+    /* let the writer in on a single CPU */
+    if (!(r->reads % 16)) {
+      sched_yield();
+    }
+  } while (!finished);
+
+  /* the last read after the writer finished sees the last publication */
+  if (last != PUBLICATIONS) {
+    r->backwards++;
+  }
+
+  return NULL;
+}
+
+int main(void) {
+  reader readers[READERS];
+  pthread_t thread;
+  bool ok = true;
+  int i;
+
+  nmea_snapshot_init(&snapshot);
+  atomic_store(&done, false);
+
+  memset(readers, 0, sizeof(readers));
+  for (i = 0; i < READERS; i++) {
+    pthread_create(&readers[i].thread, NULL, read_loop, &readers[i]);
+  }
+  pthread_create(&thread, NULL, writer, NULL);
+
+  pthread_join(thread, NULL);
+  for (i = 0; i < READERS; i++) {
+    pthread_join(readers[i].thread, NULL);
+  }
+
+  for (i = 0; i < READERS; i++) {
+    bool reader_ok = !readers[i].torn && !readers[i].backwards;
+
+    printf("reader %d: %u reads of %d publications, %u torn, %u backwards: %s\n",
+        i, readers[i].reads, PUBLICATIONS, readers[i].torn, readers[i].backwards, reader_ok ? "ok" : "FAILED");
+    ok = ok && reader_ok;
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
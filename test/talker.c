@@ -0,0 +1,141 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Talker test: determines the talker and the sentence type of the headers of
+ * the supported talkers (GP, GN, GL, GA, GB and BD, GQ) and of unknown ones,
+ * then parses a sentence of each talker through the talker filter of the
+ * parser.
+ */
+
+#include "test.h"
+
+#include <nmea/parser.h>
+
+static void test_headers(void) {
+  static const struct {
+    const char *header;
+    enum nmeaTALKER talker;
+    enum nmeaPACKTYPE type;
+  } headers[] = {
+      { "GPGGA,", TALKER_GP, GPGGA },
+      { "GNGGA,", TALKER_GN, GPGGA },
+      { "GLGSV,", TALKER_GL, GPGSV },
+      { "GAGSV,", TALKER_GA, GPGSV },
+      { "GBGSA,", TALKER_GB, GPGSA },
+      { "BDGSA,", TALKER_GB, GPGSA },
+      { "GQRMC,", TALKER_GQ, GPRMC },
+      { "GNRMC,", TALKER_GN, GPRMC },
+      { "GNVTG,", TALKER_GN, GPVTG },
+      { "GNGSA,", TALKER_GN, GPGSA },
+      /* the formatters that are not supported, for any talker */
+      { "GPXXX,", TALKER_GP, GPNON },
+      { "GNZDA,", TALKER_GN, GPNON },
+      { "GLGGX,", TALKER_GL, GPNON },
+      /* the talkers that are not supported, for any formatter */
+      { "IIGGA,", TALKER_NONE, GPNON },
+      { "LCVTG,", TALKER_NONE, GPNON },
+      { "gpgga,", TALKER_NONE, GPNON },
+      { "PGRME,", TALKER_NONE, GPNON },
+      { "GIGSV,", TALKER_NONE, GPNON },
+      /* too short */
+      { "GPGG", TALKER_GP, GPNON },
+      { "G", TALKER_NONE, GPNON },
+      { "", TALKER_NONE, GPNON }
+  };
+  size_t i;
+
+  for (i = 0; i < (sizeof(headers) / sizeof(headers[0])); i++) {
+    int len = (int) strlen(headers[i].header);
+    enum nmeaTALKER talker = nmea_parse_get_talker(headers[i].header, len);
+    enum nmeaPACKTYPE type = nmea_parse_get_sentence_type(headers[i].header, len);
+
+    if ((talker != headers[i].talker) || (type != headers[i].type)) {
+      printf("\"%s\": talker %d, type %d, expected talker %d, type %d: FAILED\n", headers[i].header, talker, type,
+          headers[i].talker, headers[i].type);
+      test_failures++;
+    }
+  }
+}
+
+#if NMEA_SENTENCE_GGA && NMEA_SENTENCE_RMC
+/**
+ * Parse a GGA and an RMC sentence of each talker (and of an unknown one)
+ *
+ * @param parser a pointer to the parser
+ * @return the number of sentences that are parsed
+ */
+static int parse_talkers(nmeaPARSER *parser) {
+  static const char *talkers[] = { "GP", "GN", "GL", "GA", "GB", "BD", "GQ", "II" };
+  nmeaINFO info;
+  int parsed = 0;
+  size_t i;
+
+  memset(&info, 0, sizeof(info));
+  for (i = 0; i < (sizeof(talkers) / sizeof(talkers[0])); i++) {
+    char body[96];
+    char buf[128];
+
+    sprintf(body, "$%sGGA,123519.000,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*", talkers[i]);
+    parsed += nmea_parse(parser, buf, test_sentence(buf, body), &info);
+    sprintf(body, "$%sRMC,123519.000,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*", talkers[i]);
+    parsed += nmea_parse(parser, buf, test_sentence(buf, body), &info);
+  }
+
+  return parsed;
+}
+
+static void test_filter(void) {
+  nmeaPARSER parser;
+#if NMEA_PARSER_STATS
+  nmeaPARSERSTATS stats;
+#endif
+
+  /* all the supported talkers */
+  nmea_parser_init(&parser);
+  CHECK(parse_talkers(&parser) == 14);
+#if NMEA_PARSER_STATS
+  nmea_parser_stats(&parser, &stats);
+  CHECK(stats.unknown == 2);
+#endif
+
+  /* the combined and the GLONASS talker */
+  nmea_parser_init(&parser);
+  nmea_parser_set_filter(&parser, GPGGA | GPRMC, NMEA_TALKER_BIT(TALKER_GN) | NMEA_TALKER_BIT(TALKER_GL));
+  CHECK(parse_talkers(&parser) == 4);
+
+  /* BeiDou under both of its talkers, GGA only */
+  nmea_parser_init(&parser);
+  nmea_parser_set_filter(&parser, GPGGA, NMEA_TALKER_BIT(TALKER_GB));
+  CHECK(parse_talkers(&parser) == 2);
+#if NMEA_PARSER_STATS
+  nmea_parser_stats(&parser, &stats);
+  CHECK(stats.filtered == 14);
+#endif
+}
+#endif
+
+int main(void) {
+  test_headers();
+#if NMEA_SENTENCE_GGA && NMEA_SENTENCE_RMC
+  test_filter();
+#endif
+
+  printf("talker: %s\n", test_failures ? "FAILED" : "ok");
+  return TEST_RESULT;
+}
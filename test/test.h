@@ -0,0 +1,107 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * The checks that the single-threaded tests share: a failed check prints its
+ * location and is counted, the test exits with TEST_RESULT. The values are
+ * compared in the units of the floating point build, so that the tests pass
+ * with and without NMEA_FIXED_POINT.
+ */
+
+#ifndef __NMEA_TEST_H__
+#define __NMEA_TEST_H__
+
+#include <nmea/gmath.h>
+#include <nmea/info.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int test_failures;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      printf("%s:%d: %s: FAILED\n", __FILE__, __LINE__, #cond); \
+      test_failures++; \
+    } \
+  } while (0)
+
+#define CHECK_NEAR(value, expected, tolerance) \
+  do { \
+    double _v = (value); \
+    double _e = (expected); \
+    if (!(fabs(_v - _e) <= (tolerance))) { \
+      printf("%s:%d: %s = %.9g, expected %.9g: FAILED\n", __FILE__, __LINE__, #value, _v, _e); \
+      test_failures++; \
+    } \
+  } while (0)
+
+#define TEST_RESULT (test_failures ? EXIT_FAILURE : EXIT_SUCCESS)
+
+/**
+ * Complete a sentence with its checksum.
+ *
+ * @param buf the buffer of the sentence, of at least strlen(body) + 5 characters
+ * @param body the sentence up to and including the '*'
+ * @return the length of the sentence
+ */
+static inline int test_sentence(char *buf, const char *body) {
+  int len = (int) strlen(body);
+  unsigned char checksum = 0;
+  int i;
+
+  for (i = 1; i < (len - 1); i++) {
+    checksum ^= (unsigned char) body[i];
+  }
+
+  memcpy(buf, body, (size_t) len);
+  return len + sprintf(&buf[len], "%02X\r\n", checksum);
+}
+
+#if NMEA_FIXED_POINT
+/** A coordinate in NDEG */
+#define TEST_NDEG(v)        ((double) nmea_degree2ndeg(nmea_coord2degree(v)))
+/** A measurement of the given scale (NMEA_LENGTH_SCALE etc.) */
+#define TEST_VALUE(v, scale) ((double) (v) / (scale))
+/** A speed of nmeaINFO in kph */
+#define TEST_KPH(v)         ((double) (v) * 3.6 / NMEA_SPEED_SCALE)
+/** A speed of a sentence that is sent in knots, in knots */
+#define TEST_KNOTS(v)       ((double) (v) * 3.6 / NMEA_SPEED_SCALE / NMEA_TUD_KNOTS)
+/** A value that full validation marks absent */
+#define TEST_NONE(v)        ((v) == INT32_MIN)
+/** The tolerance of a coordinate in NDEG (converted in nmeaFLOAT), of a measurement */
+#if NMEA_SINGLE_PRECISION
+#define TEST_NDEG_TOLERANCE 1e-3
+#else
+#define TEST_NDEG_TOLERANCE 1e-5
+#endif
+#define TEST_TOLERANCE      5e-2
+#else
+#define TEST_NDEG(v)        ((double) (v))
+#define TEST_VALUE(v, scale) ((double) (v))
+#define TEST_KPH(v)         ((double) (v))
+#define TEST_KNOTS(v)       ((double) (v))
+#define TEST_NONE(v)        isnan(v)
+#define TEST_NDEG_TOLERANCE 1e-3
+#define TEST_TOLERANCE      1e-4
+#endif
+
+#endif /* __NMEA_TEST_H__ */
@@ -0,0 +1,206 @@
+/*
+ * This file is part of nmealib.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Number parser test: compares nmea_atoi, nmea_atof and nmea_atofixed with
+ * strtol and strtod over representative NMEA numbers and edge cases (signs,
+ * white space, trailing characters, exponents, long mantissas, overflow), the
+ * exact conversions, the strtod fallback, the rounding and the clamping.
+ */
+
+#include "test.h"
+
+#include <nmea/tok.h>
+
+#include <limits.h>
+
+/**
+ * The result of strtol, clamped to an int like nmea_atoi
+ */
+static int atoi_expected(const char *s, const int radix) {
+  long res = strtol(s, NULL, radix);
+
+  if (res > INT_MAX) {
+    return INT_MAX;
+  }
+  if (res < INT_MIN) {
+    return INT_MIN;
+  }
+  return (int) res;
+}
+
+static void test_atoi(void) {
+  static const struct {
+    const char *s;
+    int radix;
+  } numbers[] = {
+      { "0", 10 }, { "42", 10 }, { "-42", 10 }, { "+7", 10 }, { " \t12", 10 }, { "0012", 10 },
+      { "12a", 10 }, { "", 10 }, { "-", 10 }, { "x", 10 }, { "2147483647", 10 }, { "2147483648", 10 },
+      { "-2147483648", 10 }, { "-2147483649", 10 }, { "99999999999999999999", 10 }, { "-99999999999", 10 },
+      { "ff", 16 }, { "FF", 16 }, { "0x1F", 16 }, { "0x", 16 }, { "7fffffff", 16 }, { "80000000", 16 },
+      { "z", 36 }, { "101", 2 }, { "777", 8 }
+  };
+  size_t i;
+
+  for (i = 0; i < (sizeof(numbers) / sizeof(numbers[0])); i++) {
+    int res = nmea_atoi(numbers[i].s, (int) strlen(numbers[i].s), numbers[i].radix);
+    int expected = atoi_expected(numbers[i].s, numbers[i].radix);
+
+    if (res != expected) {
+      printf("nmea_atoi(\"%s\", %d) = %d, expected %d: FAILED\n", numbers[i].s, numbers[i].radix, res, expected);
+      test_failures++;
+    }
+  }
+
+  /* the string does not have to be terminated, invalid radixes */
+  CHECK(nmea_atoi("1234", 2, 10) == 12);
+  CHECK(nmea_atoi("0x1F", 3, 16) == 1);
+  CHECK(nmea_atoi("12", 2, 1) == 0);
+  CHECK(nmea_atoi("12", 2, 37) == 0);
+}
+
+/**
+ * The result of strtod (strtof in single precision)
+ */
+static nmeaFLOAT atof_expected(const char *s) {
+#if NMEA_SINGLE_PRECISION
+  return strtof(s, NULL);
+#else
+  return strtod(s, NULL);
+#endif
+}
+
+static void test_atof(void) {
+  static const char *numbers[] = {
+      /* the numbers of the sentences, converted exactly */
+      "0", "-0", "-0.5", "1.5", "0.1", "0.9", "2.5", "545.4", "-12.5", "022.4", "084.4", "4807.038", "01131.000",
+      "4807.03812", "01131.00045", "123519.123", "230394", "1234567", "12345678", "0.3333333",
+      /* white space, signs, trailing characters */
+      " 12.5", "\t-1.25", "+3.75", "12.5abc", "12.5,N", ".5", "5.", "-.5",
+      /* no number */
+      "", ".", "-", "+.", "abc", ",",
+      /* exponents, hex, inf and nan: strtod */
+      "1e3", "1E-3", "-2.5e+2", "0x10", "0x1p-2", "inf", "-Infinity",
+      /* long mantissas: exactly up to 19 digits and 2^53, strtod beyond */
+      "9007199254740992", "9007199254740993", "1234567890123456789", "12345678901234567890",
+      "0.1234567890123456789", "0.12345678901234567890123", "0.0000000000000000000000001",
+      "3.141592653589793238", "00000000000000000000001.5",
+      /* overflow and underflow */
+      "1e400", "-1e400", "1e-400", "1.7976931348623157e308", "340282356779733661637539395458142568448"
+  };
+  size_t i;
+
+  for (i = 0; i < (sizeof(numbers) / sizeof(numbers[0])); i++) {
+    nmeaFLOAT res = nmea_atof(numbers[i], (int) strlen(numbers[i]));
+    nmeaFLOAT expected = atof_expected(numbers[i]);
+    bool ok;
+
+    if (strlen(numbers[i]) >= (NMEA_CONVSTR_BUF - 1)) {
+      /* too long for the buffer of the strtod fallback */
+      expected = 0;
+    }
+
+#if NMEA_SINGLE_PRECISION
+    /* correctly rounded up to 7 digits, within 1 ulp beyond */
+    ok = (res == expected) || (fabsf(res - expected) <= (nextafterf(fabsf(expected), INFINITY) - fabsf(expected)));
+#else
+    /* correctly rounded: the same as strtod */
+    ok = (res == expected) && (signbit(res) == signbit(expected));
+#endif
+    if (!ok) {
+      printf("nmea_atof(\"%s\") = %.17g, expected %.17g: FAILED\n", numbers[i], (double) res, (double) expected);
+      test_failures++;
+    }
+  }
+
+  CHECK(isnan(nmea_atof("nan", 3)));
+
+  /* the string does not have to be terminated */
+  CHECK(nmea_atof("12.345", 4) == atof_expected("12.3"));
+  CHECK(nmea_atof("1e3", 1) == 1);
+}
+
+static void test_atofixed(void) {
+  static const struct {
+    const char *s;
+    int32_t scale;
+    int64_t expected;
+  } numbers[] = {
+      /* the numbers of the sentences */
+      { "4807.038", 10000000, INT64_C(48070380000) },
+      { "01131.00045", 10000000, INT64_C(11310004500) },
+      { "545.4", 1000, 545400 },
+      { "-12.5", 1000, -12500 },
+      { "022.4", 100, 2240 },
+      { "0.9", 100, 90 },
+      /* rounding half away from zero, on the first digit beyond the scale */
+      { "0.5", 1, 1 },
+      { "-0.5", 1, -1 },
+      { "0.49", 1, 0 },
+      { "2.5", 1, 3 },
+      { "1.235", 100, 124 },
+      { "1.2349999", 100, 123 },
+      { "-1.235", 100, -124 },
+      { "0.000000005", 1000000000, 5 },
+      { "0.0000000005", 1000000000, 1 },
+      /* white space, signs, trailing characters, no number */
+      { " +12.5", 10, 125 },
+      { "12.5,N", 10, 125 },
+      { "0000000000012", 1, 12 },
+      { ".5", 10, 5 },
+      { "", 100, 0 },
+      { "-", 100, 0 },
+      { "abc", 100, 0 },
+      /* exponents are not supported */
+      { "1e3", 1, 1 },
+      /* up to 9 integer digits, clamped beyond */
+      { "999999999", 1000000000, INT64_C(999999999000000000) },
+      { "9999999999", 1, INT64_MAX },
+      { "-12345678901", 1, -INT64_MAX }
+  };
+  size_t i;
+
+  for (i = 0; i < (sizeof(numbers) / sizeof(numbers[0])); i++) {
+    int64_t res = nmea_atofixed(numbers[i].s, (int) strlen(numbers[i].s), numbers[i].scale);
+    bool ok = (res == numbers[i].expected);
+
+    /* within rounding of strtod, where that does not clamp or stop at an exponent */
+    if ((res != INT64_MAX) && (res != -INT64_MAX) && !strchr(numbers[i].s, 'e')) {
+      double expected = strtod(numbers[i].s, NULL) * numbers[i].scale;
+
+      ok = ok && (fabs((double) res - expected) <= (0.5 + (fabs(expected) * 1e-15)));
+    }
+    if (!ok) {
+      printf("nmea_atofixed(\"%s\", %d) = %lld, expected %lld: FAILED\n", numbers[i].s, (int) numbers[i].scale,
+          (long long) res, (long long) numbers[i].expected);
+      test_failures++;
+    }
+  }
+
+  /* the string does not have to be terminated */
+  CHECK(nmea_atofixed("12.345", 4, 100) == 1230);
+}
+
+int main(void) {
+  test_atoi();
+  test_atof();
+  test_atofixed();
+
+  printf("tok: %s\n", test_failures ? "FAILED" : "ok");
+  return TEST_RESULT;
+}